@@ -0,0 +1,466 @@
+#include "ofAppNoWindow.h"
+#include "ofDoublyConnectedEdgeList.h"
+#include "ofMain.h"
+#include "ofOptimizeVertexCache.h"
+#include "ofPolygonKernels.h"
+#include "ofPolygonTriangulation.h"
+#include "ofPolygonUtility.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Heap accounting, we replace the global allocator to measure the peak heap usage of each case.
+// Each allocation is prefixed with its size so that deallocation can be accounted for.
+namespace {
+constexpr std::size_t k_AllocationHeaderSize = alignof(std::max_align_t);
+std::atomic<std::size_t> s_HeapBytes { 0 };
+std::atomic<std::size_t> s_PeakHeapBytes { 0 };
+}
+
+void * operator new(std::size_t size) {
+	auto block = static_cast<char *>(std::malloc(size + k_AllocationHeaderSize));
+	if (block == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	*reinterpret_cast<std::size_t *>(block) = size;
+	auto heapBytes = s_HeapBytes.fetch_add(size) + size;
+	auto peakHeapBytes = s_PeakHeapBytes.load();
+	while (heapBytes > peakHeapBytes && !s_PeakHeapBytes.compare_exchange_weak(peakHeapBytes, heapBytes)) { }
+
+	return block + k_AllocationHeaderSize;
+}
+
+void operator delete(void * pointer) noexcept {
+	if (pointer == nullptr) {
+		return;
+	}
+
+	auto block = static_cast<char *>(pointer) - k_AllocationHeaderSize;
+	s_HeapBytes.fetch_sub(*reinterpret_cast<std::size_t *>(block));
+	std::free(block);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept {
+	operator delete(pointer);
+}
+
+// Peak resident memory of the whole process, in bytes.
+std::size_t getPeakResidentBytes() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+	return usage.ru_maxrss; // Bytes on macOS.
+#else
+	return usage.ru_maxrss * 1024; // Kilobytes on Linux.
+#endif
+#endif
+}
+
+/// @brief A benchmark measuring triangulation throughput on procedurally generated polygons.
+///
+/// Results are written to a JSON file so that they can be compared between releases.
+/// Usage: benchmark [--min-size N] [--max-size N] [--families a,b] [--time-budget seconds] [--max-repetitions N] [--threads N] [--robust 0|1] [--output path]
+class ofApp : public ofBaseApp {
+private:
+	struct Family {
+		std::string name;
+		std::function<void(std::vector<glm::vec3> &)> create;
+	};
+
+	struct Phase {
+		std::string name;
+		std::vector<double> durations;
+	};
+
+	struct Result {
+		std::string family;
+		std::size_t numVertices;
+		std::size_t numTriangles;
+		std::size_t repetitions;
+		std::size_t peakHeapBytes;
+		std::size_t peakResidentBytes;
+		std::vector<Phase> phases;
+		// Average number of vertices transformed per triangle, as extracted then once reordered, see ofOptimizeVertexCache.
+		float averageCacheMissRatio;
+		float optimizedAverageCacheMissRatio;
+		// Accumulated over repetitions, only filled when OF_POLYGON_TRIANGULATION_STATS is defined.
+		ofPolygonTriangulationStats stats;
+		std::string path;
+		std::string error;
+	};
+
+	// Typical post transform vertex cache size, reported cache miss ratios simulate it.
+	static constexpr std::size_t k_VertexCacheSize = 16;
+
+	std::size_t m_MinSize { 16 };
+	std::size_t m_MaxSize { 1 << 20 };
+	std::size_t m_MaxRepetitions { 1000 };
+	// Threads triangulating monotone polygons, 0 on the command line for the number of hardware threads.
+	std::size_t m_NumThreads { 1 };
+	// Exact geometric predicates, see ofPolygonTriangulation::setRobustPredicates().
+	bool m_RobustPredicates { false };
+	double m_TimeBudget { 1.0 };
+	std::string m_OutputPath { "benchmark.json" };
+	std::vector<std::string> m_FamilyNames { "random", "monotone", "spiral", "comb" };
+	std::vector<Result> m_Results;
+	std::vector<glm::vec3> m_Polygon;
+	// Keeps traversals from being optimized away.
+	volatile float m_TraversalSink { 0 };
+
+	static std::vector<std::string> split(const std::string & str, char separator) {
+		std::vector<std::string> tokens;
+		std::stringstream stream(str);
+		std::string token;
+		while (std::getline(stream, token, separator)) {
+			tokens.push_back(token);
+		}
+		return tokens;
+	}
+
+	static std::vector<Family> getFamilies() {
+		return {
+			{ "random", ofPolygonUtility::createPolygonRandom },
+			{ "monotone", ofPolygonUtility::createPolygonRandomMonotone },
+			{ "spiral", ofPolygonUtility::createPolygonSpiral },
+			{ "comb", ofPolygonUtility::createPolygonComb }
+		};
+	}
+
+	static double percentile(const std::vector<double> & sorted, double ratio) {
+		auto index = (std::size_t)(ratio * (sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	static std::string getPathName(ofPolygonTriangulation::Path path) {
+		switch (path) {
+		case ofPolygonTriangulation::Path::EarClipping:
+			return "earClipping";
+		case ofPolygonTriangulation::Path::Convex:
+			return "convex";
+		case ofPolygonTriangulation::Path::Monotone:
+			return "monotone";
+		default:
+			return "splitToMonotone";
+		}
+	}
+
+	static std::string getHalfEdgeLayout() {
+#ifdef OF_POLYGON_TRIANGULATION_PACKED_HALF_EDGES
+		return "packed";
+#else
+		return "structureOfArrays";
+#endif
+	}
+
+	static std::string getScalarType() {
+		if (std::is_integral<scalar_t>::value) {
+			return "fixedPoint";
+		}
+		return sizeof(scalar_t) == sizeof(double) ? "double" : "float";
+	}
+
+	// Walks the half edges of every face, reading origins and destinations,
+	// which is representative of the traversals performed by the triangulation.
+	static float traverse(ofDoublyConnectedEdgeList & dcel) {
+		auto sum = 0.0f;
+		auto facesIterator = ofDoublyConnectedEdgeList::FacesIterator(dcel);
+		do {
+			auto halfEdgesIterator = ofDoublyConnectedEdgeList::HalfEdgesIterator(facesIterator.getCurrent());
+			do {
+				auto edge = halfEdgesIterator.getCurrent();
+				sum += edge.getOrigin().getX() - edge.getDestination().getX();
+			} while (halfEdgesIterator.moveNext());
+		} while (facesIterator.moveNext());
+		return sum;
+	}
+
+	template <typename Function>
+	static double measure(Function function) {
+		auto start = std::chrono::steady_clock::now();
+		function();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double>(end - start).count();
+	}
+
+	void runCase(const Family & family, std::size_t numVertices) {
+		auto result = Result();
+		result.family = family.name;
+		result.numVertices = numVertices;
+		result.numTriangles = numVertices - 2;
+		result.repetitions = 0;
+		result.averageCacheMissRatio = 0.0f;
+		result.optimizedAverageCacheMissRatio = 0.0f;
+		result.phases = { { "initialize", {} }, { "triangulate", {} }, { "extract", {} }, { "traverse", {} }, { "optimize", {} } };
+		for (auto & phase : result.phases) {
+			phase.durations.reserve(m_MaxRepetitions);
+		}
+
+		m_Polygon.resize(numVertices);
+		family.create(m_Polygon);
+		// Generated polygons span the unit square, which fixed point coordinates would collapse.
+		ofPolygonUtility::scaleToScalarRange(m_Polygon);
+
+		// Fresh instances per case, so that the heap peak only accounts for this case.
+		const auto baseHeapBytes = s_HeapBytes.load();
+		s_PeakHeapBytes.store(baseHeapBytes);
+
+		try {
+			auto dcel = ofDoublyConnectedEdgeList();
+			auto triangulation = ofPolygonTriangulation();
+			auto optimizeVertexCache = ofOptimizeVertexCache();
+			optimizeVertexCache.setCacheSize(k_VertexCacheSize);
+			triangulation.setNumThreads(m_NumThreads);
+			triangulation.setRobustPredicates(m_RobustPredicates);
+#ifdef OF_POLYGON_TRIANGULATION_STATS
+			triangulation.setStats(&result.stats);
+			dcel.setStats(&result.stats);
+#endif
+			std::vector<glm::vec3> vertices;
+			std::vector<unsigned int> indices;
+
+			auto elapsed = 0.0;
+			// Large polygons may run a single repetition past the time budget.
+			while (result.repetitions < m_MaxRepetitions && elapsed < m_TimeBudget) {
+				auto initialize = measure([&]() { dcel.initializeFromCCWVertices(m_Polygon); });
+				auto triangulate = measure([&]() { triangulation.execute(dcel); });
+				auto extract = measure([&]() { dcel.extractTriangles(vertices, indices); });
+				auto traversal = measure([&]() { m_TraversalSink = m_TraversalSink + traverse(dcel); });
+				// Last, so that the extracted indices are in the triangulation order.
+				auto optimize = measure([&]() { optimizeVertexCache.execute(dcel); });
+
+				result.phases[0].durations.push_back(initialize);
+				result.phases[1].durations.push_back(triangulate);
+				result.phases[2].durations.push_back(extract);
+				result.phases[3].durations.push_back(traversal);
+				result.phases[4].durations.push_back(optimize);
+
+				elapsed += initialize + triangulate + extract + traversal + optimize;
+				++result.repetitions;
+			}
+
+			result.averageCacheMissRatio = ofOptimizeVertexCache::getAverageCacheMissRatio(indices, k_VertexCacheSize);
+			dcel.extractTriangles(vertices, indices);
+			result.optimizedAverageCacheMissRatio = ofOptimizeVertexCache::getAverageCacheMissRatio(indices, k_VertexCacheSize);
+
+			result.path = getPathName(triangulation.getPath());
+		} catch (const std::exception & exception) {
+			result.error = exception.what();
+		}
+
+		result.peakHeapBytes = s_PeakHeapBytes.load() - baseHeapBytes;
+		result.peakResidentBytes = getPeakResidentBytes();
+
+		std::stringstream log;
+		log << family.name << " " << numVertices << " vertices, " << result.repetitions << " repetitions";
+		for (auto & phase : result.phases) {
+			if (!phase.durations.empty()) {
+				std::sort(phase.durations.begin(), phase.durations.end());
+				log << ", " << phase.name << " " << percentile(phase.durations, 0.5) * 1e3 << "ms";
+			}
+		}
+		if (result.repetitions != 0) {
+			log << ", acmr " << result.averageCacheMissRatio << " -> " << result.optimizedAverageCacheMissRatio;
+		}
+		if (!result.error.empty()) {
+			log << ", error: " << result.error;
+		}
+		ofLogNotice() << log.str();
+
+		m_Results.push_back(result);
+	}
+
+	void writePhase(std::ostream & stream, const Result & result, const Phase & phase) const {
+		auto mean = 0.0;
+		for (auto duration : phase.durations) {
+			mean += duration;
+		}
+		mean /= phase.durations.size();
+
+		auto median = percentile(phase.durations, 0.5);
+
+		stream << "\t\t\t\t\"" << phase.name << "\": {\n"
+			   << "\t\t\t\t\t\"minSeconds\": " << phase.durations.front() << ",\n"
+			   << "\t\t\t\t\t\"meanSeconds\": " << mean << ",\n"
+			   << "\t\t\t\t\t\"p50Seconds\": " << median << ",\n"
+			   << "\t\t\t\t\t\"p90Seconds\": " << percentile(phase.durations, 0.9) << ",\n"
+			   << "\t\t\t\t\t\"p99Seconds\": " << percentile(phase.durations, 0.99) << ",\n"
+			   << "\t\t\t\t\t\"maxSeconds\": " << phase.durations.back() << ",\n"
+			   << "\t\t\t\t\t\"verticesPerSecond\": " << (median > 0 ? result.numVertices / median : 0) << ",\n"
+			   << "\t\t\t\t\t\"trianglesPerSecond\": " << (median > 0 ? result.numTriangles / median : 0) << "\n"
+			   << "\t\t\t\t}";
+	}
+
+#ifdef OF_POLYGON_TRIANGULATION_STATS
+	// Writes stats per repetition.
+	void writeStats(std::ostream & stream, const Result & result) const {
+		const auto & stats = result.stats;
+		const auto repetitions = static_cast<double>(result.repetitions);
+		auto seconds = [repetitions](ofPolygonTriangulationStats::duration_t duration) {
+			return std::chrono::duration<double>(duration).count() / repetitions;
+		};
+
+		stream << "\t\t\t\"stats\": {\n"
+			   << "\t\t\t\t\"windingCheckSeconds\": " << seconds(stats.windingCheck) << ",\n"
+			   << "\t\t\t\t\"classificationSeconds\": " << seconds(stats.classification) << ",\n"
+			   << "\t\t\t\t\"sortSeconds\": " << seconds(stats.sort) << ",\n"
+			   << "\t\t\t\t\"sweepSeconds\": " << seconds(stats.sweep) << ",\n"
+			   << "\t\t\t\t\"monotoneTriangulationSeconds\": " << seconds(stats.monotoneTriangulation) << ",\n"
+			   << "\t\t\t\t\"extractionSeconds\": " << seconds(stats.extraction) << ",\n"
+			   << "\t\t\t\t\"numDiagonals\": " << stats.numDiagonals / repetitions << ",\n"
+			   << "\t\t\t\t\"numSplitVertices\": " << stats.numSplitVertices / repetitions << ",\n"
+			   << "\t\t\t\t\"numMergeVertices\": " << stats.numMergeVertices / repetitions << ",\n"
+			   << "\t\t\t\t\"numMonotonePolygons\": " << stats.numMonotonePolygons / repetitions << ",\n"
+			   << "\t\t\t\t\"numSharedFaceIterations\": " << stats.numSharedFaceIterations / repetitions << ",\n"
+			   << "\t\t\t\t\"numFaceRelabels\": " << stats.numFaceRelabels / repetitions << "\n"
+			   << "\t\t\t}";
+	}
+#endif
+
+	void writeResults() const {
+		std::ofstream stream(m_OutputPath);
+		if (!stream) {
+			ofLogError() << "Could not write benchmark results to " << m_OutputPath;
+			return;
+		}
+
+		stream.precision(9);
+		stream << "{\n"
+			   << "\t\"benchmark\": \"ofxPolygonTriangulation\",\n"
+			   << "\t\"configuration\": {\n"
+			   << "\t\t\"minSize\": " << m_MinSize << ",\n"
+			   << "\t\t\"maxSize\": " << m_MaxSize << ",\n"
+			   << "\t\t\"timeBudgetSeconds\": " << m_TimeBudget << ",\n"
+			   << "\t\t\"maxRepetitions\": " << m_MaxRepetitions << ",\n"
+			   << "\t\t\"threads\": " << m_NumThreads << ",\n"
+			   << "\t\t\"robustPredicates\": " << (m_RobustPredicates ? "true" : "false") << ",\n"
+			   << "\t\t\"vertexCacheSize\": " << k_VertexCacheSize << ",\n"
+			   << "\t\t\"indexBytes\": " << sizeof(index_t) << ",\n"
+			   << "\t\t\"scalarType\": \"" << getScalarType() << "\",\n"
+			   << "\t\t\"instructionSet\": \"" << ofPolygonKernelsInstructionSet() << "\",\n"
+			   << "\t\t\"halfEdgeLayout\": \"" << getHalfEdgeLayout() << "\"\n"
+			   << "\t},\n"
+			   << "\t\"results\": [\n";
+
+		for (std::size_t i = 0; i != m_Results.size(); ++i) {
+			const auto & result = m_Results[i];
+			stream << "\t\t{\n"
+				   << "\t\t\t\"family\": \"" << result.family << "\",\n"
+				   << "\t\t\t\"numVertices\": " << result.numVertices << ",\n"
+				   << "\t\t\t\"numTriangles\": " << result.numTriangles << ",\n"
+				   << "\t\t\t\"repetitions\": " << result.repetitions << ",\n"
+				   << "\t\t\t\"peakHeapBytes\": " << result.peakHeapBytes << ",\n"
+				   << "\t\t\t\"peakResidentBytes\": " << result.peakResidentBytes << ",\n"
+				   << "\t\t\t\"averageCacheMissRatio\": " << result.averageCacheMissRatio << ",\n"
+				   << "\t\t\t\"optimizedAverageCacheMissRatio\": " << result.optimizedAverageCacheMissRatio << ",\n"
+				   << "\t\t\t\"path\": \"" << result.path << "\",\n";
+
+			if (!result.error.empty()) {
+				stream << "\t\t\t\"error\": \"" << result.error << "\",\n";
+			}
+
+			stream << "\t\t\t\"phases\": {\n";
+			auto first = true;
+			for (const auto & phase : result.phases) {
+				if (phase.durations.empty()) {
+					continue;
+				}
+				stream << (first ? "" : ",\n");
+				writePhase(stream, result, phase);
+				first = false;
+			}
+			stream << "\n\t\t\t}";
+#ifdef OF_POLYGON_TRIANGULATION_STATS
+			if (result.repetitions != 0) {
+				stream << ",\n";
+				writeStats(stream, result);
+			}
+#endif
+			stream << "\n"
+				   << "\t\t}" << (i + 1 != m_Results.size() ? "," : "") << "\n";
+		}
+
+		stream << "\t]\n"
+			   << "}\n";
+
+		ofLogNotice() << "Benchmark results written to " << m_OutputPath;
+	}
+
+public:
+	ofApp(int argc, char * argv[]) {
+		for (auto i = 1; i + 1 < argc; i += 2) {
+			auto key = std::string(argv[i]);
+			auto value = std::string(argv[i + 1]);
+			if (key == "--min-size") {
+				m_MinSize = std::max<std::size_t>(std::stoul(value), 16);
+			} else if (key == "--max-size") {
+				m_MaxSize = std::stoul(value);
+			} else if (key == "--families") {
+				m_FamilyNames = split(value, ',');
+			} else if (key == "--time-budget") {
+				m_TimeBudget = std::stod(value);
+			} else if (key == "--max-repetitions") {
+				m_MaxRepetitions = std::max<std::size_t>(std::stoul(value), 1);
+			} else if (key == "--threads") {
+				m_NumThreads = std::stoul(value);
+			} else if (key == "--robust") {
+				m_RobustPredicates = std::stoul(value) != 0;
+			} else if (key == "--output") {
+				m_OutputPath = value;
+			} else {
+				ofLogError() << "Unknown argument " << key;
+			}
+		}
+
+		if (m_NumThreads == 0) {
+			m_NumThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+	}
+
+	void setup() {
+		for (const auto & family : getFamilies()) {
+			if (std::find(m_FamilyNames.begin(), m_FamilyNames.end(), family.name) == m_FamilyNames.end()) {
+				continue;
+			}
+
+			for (auto size = m_MinSize; size <= m_MaxSize; size *= 4) {
+				runCase(family, size);
+			}
+		}
+
+		writeResults();
+		ofExit();
+	}
+};
+
+int main(int argc, char * argv[]) {
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>(argc, argv);
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
@@ -114,11 +114,12 @@ void ofApp::splitToMonotoneButtonPressed() {
 void ofApp::triangulateButtonPressed() {
 	m_Dcel.initializeFromCCWVertices(m_Vertices);
 	m_Triangulation.execute(m_Dcel);
-	m_Dcel.extractTriangles(m_Vertices, m_Indices);
 
+	// Vertices are those of the polygon, only indices need to be extracted.
 	m_Mesh.clear();
 	m_Mesh.addVertices(m_Vertices);
-	m_Mesh.addIndices(m_Indices);
+	m_Mesh.getIndices().resize(m_Dcel.getNumTriangles() * 3);
+	m_Dcel.extractTriangles(m_Mesh.getIndices().data());
 }
 
 void ofApp::resetButtonPressed() {
@@ -42,7 +42,6 @@ private:
 	// Cached cause there's an issue with ofSetRandomSeed afaik.
 	vector<ofColor> m_LineColors;
 	vector<glm::vec3> m_Vertices;
-	vector<ofIndexType> m_Indices;
 	stack<ofDoublyConnectedEdgeList::Face> m_FacesPendingTriangulation;
 
 	void updatePolygon(ofPolyline & line);
@@ -1,4 +1,6 @@
 #include "ofDoublyConnectedEdgeList.h"
+#include "ofPolygonKernels.h"
+#include "ofPolygonPredicates.h"
 #include <cassert>
 #include <glm/gtx/vector_angle.hpp>
 #include <stdexcept>
@@ -6,6 +8,24 @@
 // Lighten below code.
 using dcel = ofDoublyConnectedEdgeList;
 
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+dcel::ofDoublyConnectedEdgeList(ofPolygonMemoryResource * resource)
+	: m_VerticesPosition(resource)
+	, m_VerticesChain(resource)
+	, m_VerticesIncidentEdge(resource)
+	, m_FacesOuterComponent(resource)
+#ifdef OF_POLYGON_TRIANGULATION_PACKED_HALF_EDGES
+	, m_HalfEdges(resource)
+#else
+	, m_HalfEdgesOrigin(resource)
+	, m_HalfEdgesIncidentFace(resource)
+	, m_HalfEdgesPrev(resource)
+	, m_HalfEdgesNext(resource)
+#endif
+{
+}
+#endif
+
 dcel::HalfEdge dcel::Vertex::getIncidentEdge() const {
 	return dcel::HalfEdge(m_Dcel, m_Dcel->m_VerticesIncidentEdge[m_Index]);
 }
@@ -15,22 +35,22 @@ void dcel::Vertex::setIncidentEdge(const dcel::HalfEdge & halfEdge) {
 }
 
 dcel::Vertex dcel::HalfEdge::getOrigin() const {
-	return dcel::Vertex(m_Dcel, m_Dcel->m_HalfEdgesOrigin[m_Index]);
+	return dcel::Vertex(m_Dcel, m_Dcel->halfEdgeOrigin(m_Index));
 }
 
 void dcel::HalfEdge::setOrigin(const dcel::Vertex & vertex) {
-	m_Dcel->m_HalfEdgesOrigin[m_Index] = vertex.getIndex();
+	m_Dcel->halfEdgeOrigin(m_Index) = vertex.getIndex();
 }
 
 dcel::Face dcel::HalfEdge::getIncidentFace() const {
-	return dcel::Face(m_Dcel, m_Dcel->m_HalfEdgesIncidentFace[m_Index]);
+	return dcel::Face(m_Dcel, m_Dcel->halfEdgeIncidentFace(m_Index));
 }
 
 void dcel::HalfEdge::setIncidentFace(const dcel::Face & face) {
-	m_Dcel->m_HalfEdgesIncidentFace[m_Index] = face.getIndex();
+	m_Dcel->halfEdgeIncidentFace(m_Index) = face.getIndex();
 }
 
-glm::vec2 dcel::HalfEdge::getDirection() const {
+position_t dcel::HalfEdge::getDirection() const {
 	return getDestination().getPosition() - getOrigin().getPosition();
 }
 
@@ -42,13 +62,10 @@ void dcel::Face::setOuterComponent(const dcel::HalfEdge & halfEdge) {
 	m_Dcel->m_FacesOuterComponent[m_Index] = halfEdge.getIndex();
 }
 
-float cross2d(const glm::vec2 v1, const glm::vec2 v2) {
-	return v1.x * v2.y - v2.x * v1.y;
-}
-
-ofPolygonWindingOrder signedAreaToWindingOrder(float area) {
+template <class T>
+ofPolygonWindingOrder signedAreaToWindingOrder(T area) {
 	// Handled out of due diligence but unlikely.
-	if (area == 0.0f) {
+	if (area == T(0)) {
 		return ofPolygonWindingOrder::Undefined;
 	}
 
@@ -61,24 +78,32 @@ float getSignedArea(const std::vector<vecN> & vertices) {
 	auto area = 0.0f;
 	auto len = vertices.size();
 
-	for (auto i = 0; i != len; ++i) {
-		auto p1 = vertices[i];
-		auto p2 = vertices[(i + 1) % len];
-		area += cross2d(p1, p2);
+	if (len < 3) {
+		return area;
+	}
+
+	// Relative to the first position, the closing edge then adds nothing.
+	auto origin = glm::vec2(vertices[0].x, vertices[0].y);
+	auto p1 = glm::vec2(0.0f);
+
+	for (std::size_t i = 1; i != len; ++i) {
+		auto p2 = glm::vec2(vertices[i].x, vertices[i].y) - origin;
+		area += ofCross2d(p1, p2);
+		p1 = p2;
 	}
 
 	return area;
 }
 
-float getSignedArea(const dcel::Face & face) {
+ofPolygonProduct_t<scalar_t> getSignedArea(const dcel::Face & face) {
 	auto halfEdgeIterator = dcel::HalfEdgesIterator(face);
-	auto area = 0.0f;
+	auto area = ofPolygonProduct_t<scalar_t>(0);
 
 	do {
 		auto edge = halfEdgeIterator.getCurrent();
 		auto p1 = edge.getOrigin().getPosition();
 		auto p2 = edge.getDestination().getPosition();
-		area += cross2d(p1, p2);
+		area += ofCross2d(p1, p2);
 	} while (halfEdgeIterator.moveNext());
 
 	return area;
@@ -116,23 +141,32 @@ float angle(glm::vec2 a, glm::vec2 b) {
 
 float dcel::findMaxInnerAngle(ofDoublyConnectedEdgeList & dcel, const Face & face, HalfEdge & halfEdge) {
 	// Find maximal inner angle.
+	// Angles are compared using pseudo angles, only the maximal one is evaluated.
 	auto it = ofDoublyConnectedEdgeList::HalfEdgesIterator(face);
-	auto prevDir = glm::vec2();
-	auto currentDir = glm::normalize(it.getCurrent().getPrev().getDirection());
-	auto maxInnerAngle = 0.0f;
+	auto prevDir = position_t();
+	auto currentDir = it.getCurrent().getPrev().getDirection();
+	auto maxPrevDir = position_t();
+	auto maxCurrentDir = position_t();
+	auto maxPseudoAngle = ofPolygonReal_t<scalar_t>(0);
 
 	do {
 		prevDir = currentDir;
-		currentDir = glm::normalize(it.getCurrent().getDirection());
-		auto innerAngle = angle(currentDir, -prevDir);
-		if (maxInnerAngle < innerAngle) {
-			maxInnerAngle = innerAngle;
+		currentDir = it.getCurrent().getDirection();
+		auto pseudoAngle = ofPseudoAngle(currentDir, -prevDir);
+		if (maxPseudoAngle < pseudoAngle) {
+			maxPseudoAngle = pseudoAngle;
+			maxPrevDir = prevDir;
+			maxCurrentDir = currentDir;
 			halfEdge = it.getCurrent();
 		}
 
 	} while (it.moveNext());
 
-	return maxInnerAngle;
+	if (maxPseudoAngle == 0) {
+		return 0.0f;
+	}
+
+	return angle(glm::normalize(glm::vec2(maxCurrentDir)), -glm::normalize(glm::vec2(maxPrevDir)));
 }
 
 bool dcel::tryFindSharedFace(
@@ -148,6 +182,7 @@ bool dcel::tryFindSharedFace(
 
 		auto itB = dcel::FacesOnVertexIterator(vertexB);
 		do {
+			OF_POLYGON_STATS_ADD(m_Stats, numSharedFaceIterations, 1);
 			halfEdgeB = itB.getCurrent();
 			if (halfEdgeA.getIncidentFace() == halfEdgeB.getIncidentFace()) {
 				return true;
@@ -160,143 +195,308 @@ bool dcel::tryFindSharedFace(
 	return false;
 }
 
-dcel::HalfEdge dcel::createEdge() {
-	m_HalfEdgesOrigin.push_back({});
-	m_HalfEdgesIncidentFace.push_back({});
-	m_HalfEdgesTwin.push_back({});
-	m_HalfEdgesPrev.push_back({});
-	m_HalfEdgesNext.push_back({});
-	return HalfEdge(this, m_HalfEdgesOrigin.size() - 1);
+#ifdef OF_POLYGON_TRIANGULATION_PACKED_HALF_EDGES
+void dcel::resizeHalfEdges(std::size_t numHalfEdges) {
+	m_HalfEdges.resize(numHalfEdges);
+}
+
+void dcel::reserveHalfEdges(std::size_t numHalfEdges) {
+	m_HalfEdges.reserve(numHalfEdges);
+}
+#else
+void dcel::resizeHalfEdges(std::size_t numHalfEdges) {
+	m_HalfEdgesOrigin.resize(numHalfEdges);
+	m_HalfEdgesIncidentFace.resize(numHalfEdges);
+	m_HalfEdgesPrev.resize(numHalfEdges);
+	m_HalfEdgesNext.resize(numHalfEdges);
+}
+
+void dcel::reserveHalfEdges(std::size_t numHalfEdges) {
+	m_HalfEdgesOrigin.reserve(numHalfEdges);
+	m_HalfEdgesIncidentFace.reserve(numHalfEdges);
+	m_HalfEdgesPrev.reserve(numHalfEdges);
+	m_HalfEdgesNext.reserve(numHalfEdges);
+}
+#endif
+
+dcel::HalfEdge dcel::createEdgePairs(std::size_t numPairs) {
+	const auto index = getNumHalfEdges();
+
+	if (numPairs > (std::numeric_limits<index_t>::max() - index) / 2) {
+		throw std::runtime_error("Too many half edges for the index type.");
+	}
+
+	resizeHalfEdges(index + numPairs * 2);
+	OF_POLYGON_STATS_ADD(m_Stats, numDiagonals, numPairs);
+	return HalfEdge(this, static_cast<index_t>(index));
+}
+
+dcel::HalfEdge dcel::allocateHalfEdgePairs(std::size_t numPairs) {
+	if (m_FaceAssignment != FaceAssignment::Deferred) {
+		throw std::runtime_error("Allocating half edges requires deferred face assignment.");
+	}
+
+	// Pairs are expected to be connected, faces are assigned later on.
+	m_FacesDirty = true;
+	return createEdgePairs(numPairs);
 }
 
 dcel::Face dcel::createFace() {
 	m_FacesOuterComponent.push_back({});
-	return Face(this, m_FacesOuterComponent.size() - 1);
+	return Face(this, static_cast<index_t>(m_FacesOuterComponent.size() - 1));
 }
 
 // Leans on a convention, see k_InnerFaceIndex.
 dcel::Face dcel::getInnerFace() {
+	assignFaces();
 	if (m_FacesOuterComponent.size() < k_InnerFaceIndex + 1) {
 		throw std::runtime_error("Cannot access inner face.");
 	}
 	return dcel::Face(this, k_InnerFaceIndex);
 }
 
-template <class vecN>
-void dcel::initializeFromCCWVertices(const std::vector<vecN> & vertices) {
-	if (getWindingOrder(vertices) != ofPolygonWindingOrder::CounterClockWise) {
-		throw std::runtime_error("Passed vertices should be in counter clockwise order.");
+void dcel::reserve(std::size_t numVertices) {
+	// Triangulation adds n - 3 diagonals, each made of 2 half edges and adding a face.
+	const auto numDiagonals = numVertices > 3 ? numVertices - 3 : 0;
+	const auto numHalfEdges = numVertices * 2 + numDiagonals * 2;
+	const auto numFaces = 2 + numDiagonals;
+
+	m_VerticesPosition.reserve(numVertices);
+	m_VerticesChain.reserve(numVertices);
+	m_VerticesIncidentEdge.reserve(numVertices);
+
+	m_FacesOuterComponent.reserve(numFaces);
+
+	reserveHalfEdges(numHalfEdges);
+}
+
+void dcel::clear() {
+	m_VerticesPosition.clear();
+	m_VerticesChain.clear();
+	m_VerticesIncidentEdge.clear();
+	m_FacesOuterComponent.clear();
+	resizeHalfEdges(0);
+	m_FacesDirty = false;
+}
+
+template <class PositionAccessor>
+void dcel::initializeFromCCWVertices(std::size_t numVertices, PositionAccessor getPosition) {
+	const auto len = numVertices;
+
+	if (len > getMaxNumVertices()) {
+		throw std::runtime_error("Too many vertices for the index type.");
 	}
 
-	const auto len = vertices.size();
+	reserve(len);
 
 	m_VerticesPosition.resize(len);
 	m_VerticesChain.resize(len);
 	m_VerticesIncidentEdge.resize(len);
 
 	// *2, outer and inner faces, len edges per face.
-	m_HalfEdgesOrigin.resize(len * 2);
-	m_HalfEdgesIncidentFace.resize(len * 2);
-	m_HalfEdgesTwin.resize(len * 2);
-	m_HalfEdgesPrev.resize(len * 2);
-	m_HalfEdgesNext.resize(len * 2);
+	resizeHalfEdges(len * 2);
 
 	// 2, outer and inner faces.
 	m_FacesOuterComponent.resize(2);
+	m_FacesDirty = false;
+
+	// Half edges come in pairs, the inner half edge leaving vertex i is 2i, its outer twin is 2i + 1.
 
 	// Outer face.
-	m_FacesOuterComponent[k_OuterFaceIndex] = len;
+	m_FacesOuterComponent[k_OuterFaceIndex] = 1;
 
 	// Inner face.
 	m_FacesOuterComponent[k_InnerFaceIndex] = 0;
 
-	for (auto i = 0; i != len; ++i) {
-		m_VerticesPosition[i] = vertices[i];
+	for (index_t i = 0; i != len; ++i) {
+		m_VerticesPosition[i] = getPosition(i);
 		m_VerticesChain[i] = dcel::Chain::None;
-		m_VerticesIncidentEdge[i] = i;
 
-		auto prevIndex = (i - 1 + len) % len;
+		auto prevIndex = (i + len - 1) % len;
 		auto nextIndex = (i + 1) % len;
-		auto twinIndex = i + len;
-
-		m_HalfEdgesOrigin[i] = i;
-		m_HalfEdgesIncidentFace[i] = k_InnerFaceIndex;
-		m_HalfEdgesTwin[i] = twinIndex;
-		m_HalfEdgesPrev[i] = prevIndex;
-		m_HalfEdgesNext[i] = nextIndex;
-
-		m_HalfEdgesOrigin[twinIndex] = nextIndex;
-		m_HalfEdgesIncidentFace[twinIndex] = k_OuterFaceIndex;
-		m_HalfEdgesTwin[twinIndex] = i;
-		m_HalfEdgesPrev[twinIndex] = nextIndex + len;
-		m_HalfEdgesNext[twinIndex] = prevIndex + len;
+		auto edgeIndex = i * 2;
+		auto twinIndex = edgeIndex + 1;
+
+		m_VerticesIncidentEdge[i] = edgeIndex;
+
+		halfEdgeOrigin(edgeIndex) = i;
+		halfEdgeIncidentFace(edgeIndex) = k_InnerFaceIndex;
+		halfEdgePrev(edgeIndex) = prevIndex * 2;
+		halfEdgeNext(edgeIndex) = nextIndex * 2;
+
+		halfEdgeOrigin(twinIndex) = nextIndex;
+		halfEdgeIncidentFace(twinIndex) = k_OuterFaceIndex;
+		halfEdgePrev(twinIndex) = nextIndex * 2 + 1;
+		halfEdgeNext(twinIndex) = prevIndex * 2 + 1;
+	}
+
+	// The winding order is evaluated in a dense pass over the copied positions.
+	auto area = ofPolygonProduct_t<scalar_t>(0);
+	{
+		OF_POLYGON_STATS_SCOPE(m_Stats, windingCheck);
+		area = ofPolygonSignedArea(m_VerticesPosition.data(), len);
 	}
+
+	if (signedAreaToWindingOrder(area) != ofPolygonWindingOrder::CounterClockWise) {
+		clear();
+		throw std::runtime_error("Passed vertices should be in counter clockwise order.");
+	}
+}
+
+// Position accessors for buffers of any supported coordinate type, converting to scalar_t.
+template <class T>
+auto getInterleavedPositions(const T * positions, std::size_t stride) {
+	const auto bytes = reinterpret_cast<const char *>(positions);
+	return [bytes, stride](index_t i) {
+		auto position = reinterpret_cast<const T *>(bytes + i * stride);
+		return position_t(position[0], position[1]);
+	};
+}
+
+template <class T>
+auto getSeparatePositions(const T * xs, const T * ys) {
+	return [xs, ys](index_t i) { return position_t(xs[i], ys[i]); };
 }
 
 void dcel::initializeFromCCWVertices(const std::vector<glm::vec2> & vertices) {
-	initializeFromCCWVertices<glm::vec2>(vertices);
+	initializeFromCCWVertices(vertices.size(), [&vertices](index_t i) { return position_t(vertices[i].x, vertices[i].y); });
 }
 
 void dcel::initializeFromCCWVertices(const std::vector<glm::vec3> & vertices) {
-	initializeFromCCWVertices<glm::vec3>(vertices);
+	initializeFromCCWVertices(vertices.size(), [&vertices](index_t i) { return position_t(vertices[i].x, vertices[i].y); });
+}
+
+void dcel::initializeFromCCWVertices(const float * positions, std::size_t numVertices, std::size_t stride) {
+	initializeFromCCWVertices(numVertices, getInterleavedPositions(positions, stride));
+}
+
+void dcel::initializeFromCCWVertices(const float * xs, const float * ys, std::size_t numVertices) {
+	initializeFromCCWVertices(numVertices, getSeparatePositions(xs, ys));
+}
+
+void dcel::initializeFromCCWVertices(const double * positions, std::size_t numVertices, std::size_t stride) {
+	initializeFromCCWVertices(numVertices, getInterleavedPositions(positions, stride));
+}
+
+void dcel::initializeFromCCWVertices(const double * xs, const double * ys, std::size_t numVertices) {
+	initializeFromCCWVertices(numVertices, getSeparatePositions(xs, ys));
+}
+
+void dcel::initializeFromCCWVertices(const std::int32_t * positions, std::size_t numVertices, std::size_t stride) {
+	initializeFromCCWVertices(numVertices, getInterleavedPositions(positions, stride));
+}
+
+void dcel::initializeFromCCWVertices(const std::int32_t * xs, const std::int32_t * ys, std::size_t numVertices) {
+	initializeFromCCWVertices(numVertices, getSeparatePositions(xs, ys));
 }
 
 void dcel::extractTriangles(
 	std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices) {
 	vertices.resize(m_VerticesPosition.size());
-	indices.resize((m_FacesOuterComponent.size() - 1) * 3); // -1 to exclude outer face.
+	indices.resize(getNumTriangles() * 3);
+
+	if (!vertices.empty()) {
+		extractVertices(&vertices[0].x);
+	}
+
+	if (!indices.empty()) {
+		extractTriangles(indices.data());
+	}
+}
+
+std::size_t dcel::getNumTriangles() {
+	assignFaces();
+	// -1 to exclude outer face.
+	return m_FacesOuterComponent.empty() ? 0 : m_FacesOuterComponent.size() - 1;
+}
+
+template <class IndexType>
+void dcel::extractTriangles(IndexType * indices, std::size_t baseVertex) {
+	assignFaces();
+	OF_POLYGON_STATS_SCOPE(m_Stats, extraction);
+
+	if (!m_VerticesPosition.empty() && baseVertex + m_VerticesPosition.size() - 1 > std::numeric_limits<IndexType>::max()) {
+		throw std::runtime_error("Too many vertices for the index type.");
+	}
 
 	// Iteration starts at 1 to exclude outer face.
 	// If the face isn't a triangle, we'll simply ignore vertices beyond the third.
 	// It will lead to an incorrect geometry but will not raise errors.
-	for (auto i = 1; i != m_FacesOuterComponent.size(); ++i) {
+	for (std::size_t i = 1; i < m_FacesOuterComponent.size(); ++i) {
 		auto edgeIndex = m_FacesOuterComponent[i];
 		auto index = (i - 1) * 3;
-		indices[index] = m_HalfEdgesOrigin[edgeIndex];
-		edgeIndex = m_HalfEdgesNext[edgeIndex];
-		indices[index + 1] = m_HalfEdgesOrigin[edgeIndex];
-		edgeIndex = m_HalfEdgesNext[edgeIndex];
-		indices[index + 2] = m_HalfEdgesOrigin[edgeIndex];
+		indices[index] = static_cast<IndexType>(baseVertex + halfEdgeOrigin(edgeIndex));
+		edgeIndex = halfEdgeNext(edgeIndex);
+		indices[index + 1] = static_cast<IndexType>(baseVertex + halfEdgeOrigin(edgeIndex));
+		edgeIndex = halfEdgeNext(edgeIndex);
+		indices[index + 2] = static_cast<IndexType>(baseVertex + halfEdgeOrigin(edgeIndex));
 	}
+}
+
+void dcel::extractTriangles(unsigned int * indices, unsigned int baseVertex) {
+	extractTriangles<unsigned int>(indices, baseVertex);
+}
+
+void dcel::extractTriangles(std::uint16_t * indices, std::uint16_t baseVertex) {
+	extractTriangles<std::uint16_t>(indices, baseVertex);
+}
+
+void dcel::reorderFaces(const index_t * outerComponents) {
+	assignFaces();
 
-	for (auto i = 0; i != m_VerticesPosition.size(); ++i) {
-		auto position = m_VerticesPosition[i];
-		vertices[i] = glm::vec3(position.x, position.y, 0);
+	// Faces are walked through next half edges, so incident faces can be overwritten as we go.
+	for (std::size_t i = k_InnerFaceIndex; i < m_FacesOuterComponent.size(); ++i) {
+		const auto firstEdgeIndex = outerComponents[i - k_InnerFaceIndex];
+		assert(halfEdgeIncidentFace(firstEdgeIndex) != k_OuterFaceIndex);
+		m_FacesOuterComponent[i] = firstEdgeIndex;
+
+		auto edgeIndex = firstEdgeIndex;
+		do {
+			halfEdgeIncidentFace(edgeIndex) = static_cast<index_t>(i);
+			edgeIndex = halfEdgeNext(edgeIndex);
+		} while (edgeIndex != firstEdgeIndex);
 	}
 }
 
-dcel::HalfEdge dcel::addHalfEdge(dcel::HalfEdge & edgeA, dcel::HalfEdge & edgeB) {
+void dcel::extractVertices(float * positions, std::size_t stride) {
+	OF_POLYGON_STATS_SCOPE(m_Stats, extraction);
+	auto bytes = reinterpret_cast<char *>(positions);
+
+	for (std::size_t i = 0; i != m_VerticesPosition.size(); ++i) {
+		auto position = reinterpret_cast<float *>(bytes + i * stride);
+		position[0] = static_cast<float>(m_VerticesPosition[i].x);
+		position[1] = static_cast<float>(m_VerticesPosition[i].y);
+		position[2] = 0;
+	}
+}
+
+void dcel::validateSplit(const dcel::HalfEdge & edgeA, const dcel::HalfEdge & edgeB) const {
 	if (edgeA.getIncidentFace().getIndex() == k_OuterFaceIndex) {
 		throw std::runtime_error("Cannot split outer face.");
 	}
 
-	if (edgeA.getIncidentFace() != edgeB.getIncidentFace()) {
+	// Incident faces may be stale in deferred mode, only the outer face is reliable.
+	if (m_FaceAssignment == FaceAssignment::Immediate && edgeA.getIncidentFace() != edgeB.getIncidentFace()) {
 		throw std::runtime_error("Cannot split half edges are on different faces.");
 	}
 
 	if (edgeA.getNext() == edgeB || edgeA.getPrev() == edgeB) {
 		throw std::runtime_error("Cannot split adjacent vertices.");
 	}
+}
 
-	auto face = edgeA.getIncidentFace();
+dcel::Face dcel::connectEdgePair(const dcel::HalfEdge & halfEdgeA, const dcel::HalfEdge & halfEdgeB, const dcel::HalfEdge & halfEdge) {
+	auto edgeA = halfEdgeA;
+	auto edgeB = halfEdgeB;
+	auto newEdge = halfEdge;
+	auto newEdgeTwin = newEdge.getTwin();
 
-	// Create two new edges and a new face;
-	auto newEdge = createEdge();
-	auto newEdgeTwin = createEdge();
-	auto newFace = createFace();
+	auto face = edgeA.getIncidentFace();
 
 	// Set new edges origins.
 	newEdge.setOrigin(edgeA.getOrigin());
 	newEdgeTwin.setOrigin(edgeB.getOrigin());
 
-	// Update faces outer components.
-	face.setOuterComponent(newEdge);
-	newFace.setOuterComponent(newEdgeTwin);
-
-	// Connect twins.
-	newEdge.setTwin(newEdgeTwin);
-	newEdgeTwin.setTwin(newEdge);
-
 	// Connect new edges.
 	newEdge.setPrev(edgeA.getPrev());
 	newEdge.setNext(edgeB);
@@ -312,8 +512,35 @@ dcel::HalfEdge dcel::addHalfEdge(dcel::HalfEdge & edgeA, dcel::HalfEdge & edgeB)
 	// Set incident faces.
 	// Recall that pre-existing edges on the face already were set to "face".
 	newEdge.setIncidentFace(face);
+	// The twin side becomes a new face, assigned by the caller in immediate mode, left to the next faces assignment otherwise.
+	newEdgeTwin.setIncidentFace(face);
+
+	return face;
+}
+
+dcel::HalfEdge dcel::addHalfEdge(const dcel::HalfEdge & edgeA, const dcel::HalfEdge & edgeB) {
+	validateSplit(edgeA, edgeB);
+
+	// Create two new twin edges;
+	auto newEdge = createEdgePairs();
+	auto newEdgeTwin = newEdge.getTwin();
+
+	auto face = connectEdgePair(edgeA, edgeB, newEdge);
+
+	// Leave the new face to the next faces assignment.
+	if (m_FaceAssignment == FaceAssignment::Deferred) {
+		m_FacesDirty = true;
+		return newEdge;
+	}
+
+	// Create a new face and update faces outer components.
+	auto newFace = createFace();
+	face.setOuterComponent(newEdge);
+	newFace.setOuterComponent(newEdgeTwin);
+
 	auto edge = newEdgeTwin;
 	do {
+		OF_POLYGON_STATS_ADD(m_Stats, numFaceRelabels, 1);
 		edge.setIncidentFace(newFace);
 		edge = edge.getNext();
 	} while (edge != newEdgeTwin);
@@ -321,12 +548,67 @@ dcel::HalfEdge dcel::addHalfEdge(dcel::HalfEdge & edgeA, dcel::HalfEdge & edgeB)
 	return newEdge;
 }
 
-dcel::HalfEdge dcel::addHalfEdge(dcel::Vertex & vertexA, dcel::Vertex & vertexB) {
+dcel::HalfEdge dcel::addHalfEdge(const dcel::HalfEdge & edgeA, const dcel::HalfEdge & edgeB, const dcel::HalfEdge & newEdge) {
+	if (m_FaceAssignment != FaceAssignment::Deferred) {
+		throw std::runtime_error("Adding allocated half edges requires deferred face assignment.");
+	}
+
+	validateSplit(edgeA, edgeB);
+
+	// Faces were marked dirty when the pair was allocated, we do not write shared state.
+	connectEdgePair(edgeA, edgeB, newEdge);
+	return newEdge;
+}
+
+dcel::HalfEdge dcel::addHalfEdge(const dcel::Vertex & vertexA, const dcel::Vertex & vertexB) {
+	assignFaces();
+
 	HalfEdge halfEdgeA;
 	HalfEdge halfEdgeB;
-	if (tryFindSharedFace(vertexA, vertexB, halfEdgeA, halfEdgeB)) {
-		addHalfEdge(halfEdgeA, halfEdgeB);
-	} else {
+	if (!tryFindSharedFace(vertexA, vertexB, halfEdgeA, halfEdgeB)) {
 		throw std::runtime_error("Vertices do not share a face.");
 	}
+	return addHalfEdge(halfEdgeA, halfEdgeB);
+}
+
+void dcel::setFaceAssignment(dcel::FaceAssignment faceAssignment) {
+	m_FaceAssignment = faceAssignment;
+	assignFaces();
+}
+
+void dcel::assignFaces() {
+	if (!m_FacesDirty) {
+		return;
+	}
+
+	m_FacesDirty = false;
+
+	// Keep the outer face only, inner faces are renumbered.
+	m_FacesOuterComponent.resize(k_OuterFaceIndex + 1);
+
+	const auto numHalfEdges = static_cast<index_t>(getNumHalfEdges());
+
+	// The outer face is never split, its half edges keep their face.
+	for (index_t i = 0; i != numHalfEdges; ++i) {
+		if (halfEdgeIncidentFace(i) != k_OuterFaceIndex) {
+			halfEdgeIncidentFace(i) = k_UnassignedFaceIndex;
+		}
+	}
+
+	// Each half edge is visited twice at most, once by the loop above and once when walking its face.
+	for (index_t i = 0; i != numHalfEdges; ++i) {
+		if (halfEdgeIncidentFace(i) != k_UnassignedFaceIndex) {
+			continue;
+		}
+
+		auto face = createFace();
+		face.setOuterComponent(HalfEdge(this, i));
+
+		auto edgeIndex = i;
+		do {
+			OF_POLYGON_STATS_ADD(m_Stats, numFaceRelabels, 1);
+			halfEdgeIncidentFace(edgeIndex) = face.getIndex();
+			edgeIndex = halfEdgeNext(edgeIndex);
+		} while (edgeIndex != i);
+	}
 }
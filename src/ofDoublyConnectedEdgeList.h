@@ -1,10 +1,19 @@
 /// \file ofDoublyConnectedEdgeList.h
 #pragma once
 
+#include "ofPolygonTriangulationStats.h"
+#include <cassert>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <limits>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+#include <memory_resource>
+#endif
+
 /// \brief Winding order of a polygon vertices.
 enum class ofPolygonWindingOrder {
 	/// @brief Vertices are in undetermined order.
@@ -15,7 +24,43 @@ enum class ofPolygonWindingOrder {
 	CounterClockWise,
 };
 
-using index_t = std::size_t;
+// The type of the indices connecting vertices, half edges and faces.
+// 32 bits by default, define OF_POLYGON_TRIANGULATION_INDEX_TYPE to std::uint16_t for small polygons,
+// or to std::size_t for very large ones.
+#ifndef OF_POLYGON_TRIANGULATION_INDEX_TYPE
+#define OF_POLYGON_TRIANGULATION_INDEX_TYPE std::uint32_t
+#endif
+
+using index_t = OF_POLYGON_TRIANGULATION_INDEX_TYPE;
+
+static_assert(std::is_unsigned<index_t>::value, "Indices must be unsigned integers.");
+
+// The type of the vertices coordinates.
+// Single precision by default, define OF_POLYGON_TRIANGULATION_SCALAR_TYPE to double to triangulate
+// geographic data without a lossy conversion, or to std::int32_t for fixed point coordinates,
+// within +/- 2^29, with which predicates are exact.
+#ifndef OF_POLYGON_TRIANGULATION_SCALAR_TYPE
+#define OF_POLYGON_TRIANGULATION_SCALAR_TYPE float
+#endif
+
+using scalar_t = OF_POLYGON_TRIANGULATION_SCALAR_TYPE;
+using position_t = glm::vec<2, scalar_t>;
+
+static_assert(std::is_floating_point<scalar_t>::value || std::is_same<scalar_t, std::int32_t>::value,
+	"Coordinates must be floating point numbers or 32 bits integers.");
+
+// The containers of edge lists and triangulation scratch memory.
+// They allocate from the global heap by default, define OF_POLYGON_TRIANGULATION_PMR to back them with
+// polymorphic allocators, so that instances may be constructed with a memory resource, a per frame arena for example.
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+using ofPolygonMemoryResource = std::pmr::memory_resource;
+
+template <class T>
+using ofPolygonVector = std::pmr::vector<T>;
+#else
+template <class T>
+using ofPolygonVector = std::vector<T>;
+#endif
 
 /// @brief A class implementing a doubly connected edge list data structure.
 class ofDoublyConnectedEdgeList {
@@ -43,6 +88,14 @@ public:
 		Bottom
 	};
 
+	/// @brief Controls when incident faces are assigned as half edges are added.
+	enum class FaceAssignment {
+		/// @brief Faces are assigned as each half edge is added, walking the new face.
+		Immediate,
+		/// @brief Faces are assigned in a single pass when next needed, adding an half edge is constant time.
+		Deferred
+	};
+
 	// Forward declaration as Vertex, HalfEdge and Face depend on one another.
 	struct HalfEdge;
 	struct Face;
@@ -59,9 +112,9 @@ public:
 
 		inline index_t getIndex() const { return m_Index; }
 
-		inline glm::vec2 getPosition() const { return m_Dcel->m_VerticesPosition[m_Index]; }
-		inline float getX() const { return getPosition().x; }
-		inline float getY() const { return getPosition().y; }
+		inline position_t getPosition() const { return m_Dcel->m_VerticesPosition[m_Index]; }
+		inline scalar_t getX() const { return getPosition().x; }
+		inline scalar_t getY() const { return getPosition().y; }
 
 		inline Chain getChain() const { return m_Dcel->m_VerticesChain[m_Index]; }
 		inline void setChain(Chain chain) { m_Dcel->m_VerticesChain[m_Index] = chain; }
@@ -89,14 +142,14 @@ public:
 
 		inline index_t getIndex() const { return m_Index; }
 
-		inline HalfEdge getTwin() const { return HalfEdge(m_Dcel, m_Dcel->m_HalfEdgesTwin[m_Index]); }
-		inline void setTwin(const HalfEdge & halfEdge) { m_Dcel->m_HalfEdgesTwin[m_Index] = halfEdge.getIndex(); }
+		// Half edges are allocated in pairs, twins only differ by their lowest bit.
+		inline HalfEdge getTwin() const { return HalfEdge(m_Dcel, m_Index ^ 1); }
 
-		inline HalfEdge getPrev() const { return HalfEdge(m_Dcel, m_Dcel->m_HalfEdgesPrev[m_Index]); }
-		inline void setPrev(const HalfEdge & halfEdge) { m_Dcel->m_HalfEdgesPrev[m_Index] = halfEdge.getIndex(); }
+		inline HalfEdge getPrev() const { return HalfEdge(m_Dcel, m_Dcel->halfEdgePrev(m_Index)); }
+		inline void setPrev(const HalfEdge & halfEdge) { m_Dcel->halfEdgePrev(m_Index) = halfEdge.getIndex(); }
 
-		inline HalfEdge getNext() const { return HalfEdge(m_Dcel, m_Dcel->m_HalfEdgesNext[m_Index]); }
-		inline void setNext(const HalfEdge & halfEdge) { m_Dcel->m_HalfEdgesNext[m_Index] = halfEdge.getIndex(); }
+		inline HalfEdge getNext() const { return HalfEdge(m_Dcel, m_Dcel->halfEdgeNext(m_Index)); }
+		inline void setNext(const HalfEdge & halfEdge) { m_Dcel->halfEdgeNext(m_Index) = halfEdge.getIndex(); }
 
 		Vertex getOrigin() const;
 		void setOrigin(const Vertex & vertex);
@@ -106,7 +159,7 @@ public:
 		Face getIncidentFace() const;
 		void setIncidentFace(const Face & face);
 
-		glm::vec2 getDirection() const;
+		position_t getDirection() const;
 
 	private:
 		index_t m_Index;
@@ -135,51 +188,125 @@ public:
 
 private:
 	// Vertices.
-	std::vector<glm::vec2> m_VerticesPosition;
-	std::vector<Chain> m_VerticesChain;
-	std::vector<index_t> m_VerticesIncidentEdge;
+	ofPolygonVector<position_t> m_VerticesPosition;
+	ofPolygonVector<Chain> m_VerticesChain;
+	ofPolygonVector<index_t> m_VerticesIncidentEdge;
 
 	// Faces.
-	std::vector<index_t> m_FacesOuterComponent;
+	ofPolygonVector<index_t> m_FacesOuterComponent;
 
 	// Half edges.
-	std::vector<index_t> m_HalfEdgesOrigin;
-	std::vector<index_t> m_HalfEdgesIncidentFace;
-	std::vector<index_t> m_HalfEdgesTwin;
-	std::vector<index_t> m_HalfEdgesPrev;
-	std::vector<index_t> m_HalfEdgesNext;
+#ifdef OF_POLYGON_TRIANGULATION_PACKED_HALF_EDGES
+	// The properties read together when circulating are packed in a single record.
+	struct HalfEdgeRecord {
+		index_t origin;
+		index_t next;
+		index_t prev;
+		index_t incidentFace;
+	};
+
+	ofPolygonVector<HalfEdgeRecord> m_HalfEdges;
+
+	inline index_t & halfEdgeOrigin(index_t index) { return m_HalfEdges[index].origin; }
+	inline index_t & halfEdgeIncidentFace(index_t index) { return m_HalfEdges[index].incidentFace; }
+	inline index_t & halfEdgePrev(index_t index) { return m_HalfEdges[index].prev; }
+	inline index_t & halfEdgeNext(index_t index) { return m_HalfEdges[index].next; }
+	inline std::size_t getNumHalfEdges() const { return m_HalfEdges.size(); }
+#else
+	ofPolygonVector<index_t> m_HalfEdgesOrigin;
+	ofPolygonVector<index_t> m_HalfEdgesIncidentFace;
+	ofPolygonVector<index_t> m_HalfEdgesPrev;
+	ofPolygonVector<index_t> m_HalfEdgesNext;
+
+	inline index_t & halfEdgeOrigin(index_t index) { return m_HalfEdgesOrigin[index]; }
+	inline index_t & halfEdgeIncidentFace(index_t index) { return m_HalfEdgesIncidentFace[index]; }
+	inline index_t & halfEdgePrev(index_t index) { return m_HalfEdgesPrev[index]; }
+	inline index_t & halfEdgeNext(index_t index) { return m_HalfEdgesNext[index]; }
+	inline std::size_t getNumHalfEdges() const { return m_HalfEdgesOrigin.size(); }
+#endif
+
+	void resizeHalfEdges(std::size_t numHalfEdges);
+	void reserveHalfEdges(std::size_t numHalfEdges);
+
+	FaceAssignment m_FaceAssignment { FaceAssignment::Immediate };
+	// True when half edges were added since faces were last assigned.
+	bool m_FacesDirty { false };
+	ofPolygonTriangulationStats * m_Stats { nullptr };
 
 	bool tryFindSharedFace(
 		const Vertex & vertexA, const Vertex & vertexB,
 		HalfEdge & halfEdgeA, HalfEdge & halfEdgeB) const;
 
-	// Private template, DRY but safe API.
-	template <class vecN>
-	void initializeFromCCWVertices(const std::vector<vecN> & vertices);
+	// Private templates, DRY but safe API.
+	// The accessor returns the position of a vertex given its index, each position is read once.
+	template <class PositionAccessor>
+	void initializeFromCCWVertices(std::size_t numVertices, PositionAccessor getPosition);
 	template <class vecN>
 	static ofPolygonWindingOrder getWindingOrder(const std::vector<vecN> & vertices);
-
-	HalfEdge createEdge();
+	template <class IndexType>
+	void extractTriangles(IndexType * indices, std::size_t baseVertex);
+
+	// Creates pairs of twin half edges, returns the first one, pairs are contiguous.
+	HalfEdge createEdgePairs(std::size_t numPairs = 1);
+	// Checks that a diagonal can connect two half edges.
+	void validateSplit(const HalfEdge & edgeA, const HalfEdge & edgeB) const;
+	// Connects a pair of half edges between two half edges, returns the split face.
+	Face connectEdgePair(const HalfEdge & edgeA, const HalfEdge & edgeB, const HalfEdge & newEdge);
 	Face createFace();
+	// Empties the doubly connected edge list, memory is kept for reuse.
+	void clear();
 	// As we initialize a DCEL, we start with 2 faces.
 	// Inside the polygon and outside of it, respectively.
 	// The indices we choose are a convention on our part.
 	static constexpr int k_OuterFaceIndex = 0;
 	static constexpr int k_InnerFaceIndex = 1;
+	// Marks half edges not yet visited when assigning faces.
+	static constexpr index_t k_UnassignedFaceIndex = std::numeric_limits<index_t>::max();
 
 public:
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	ofDoublyConnectedEdgeList() = default;
+
+	/// @brief Creates an empty doubly connected edge list, allocating from a memory resource.
+	/// @param resource The memory resource, which must outlive the doubly connected edge list.
+	explicit ofDoublyConnectedEdgeList(ofPolygonMemoryResource * resource);
+#endif
+
+	/// @brief Returns the maximal number of vertices of a polygon, given the index type.
+	///
+	/// The half edges of a triangulated polygon of n vertices must be indexable, the maximal index being reserved.
+	constexpr static std::size_t getMaxNumVertices() { return std::numeric_limits<index_t>::max() / 4; }
+
 	/// @brief Returns the total number of vertices.
 	/// @return The number of vertices.
 	inline std::size_t getNumVertices() const { return m_VerticesPosition.size(); };
 
+	/// @brief Exposes the positions of the vertices, indexed by vertex.
+	/// @return A pointer to getNumVertices() contiguous positions.
+	inline const position_t * getPositions() const { return m_VerticesPosition.data(); }
+
+	/// @brief Returns whether no half edge was added since initialization.
+	///
+	/// The inner face is then the initial polygon, whose vertices follow each other in index order,
+	/// so that dense passes over positions apply, see ofPolygonKernels.h.
+	inline bool isInitialPolygon() const { return getNumHalfEdges() == 2 * getNumVertices(); }
+
 	/// @brief Exposes the inner face of the doubly connected edge list.
 	/// @return The inner face of the doubly connected edge list.
 	Face getInnerFace();
 
+	/// @brief Reserves memory for the triangulation of a polygon.
+	/// @param numVertices The number of vertices of the polygon.
+	///
+	/// A triangulated polygon of n vertices has 2n + 2(n - 3) half edges and n - 1 faces, including the outer face.
+	/// Memory is never released, so initializing and triangulating polygons with as many vertices or less does not allocate.
+	void reserve(std::size_t numVertices);
+
 	/// @brief Initializes the doubly connected edge list from a list of points representing a polygon.
 	/// @param vertices A vector of polygon points in 2 dimensions.
 	///
 	/// Points are expected to be sorted in count clockwise order.
+	/// Memory is reserved for the triangulation of the polygon.
 	void initializeFromCCWVertices(const std::vector<glm::vec2> & vertices);
 
 	/// @brief Initializes the doubly connected edge list from a list of points representing a polygon.
@@ -187,19 +314,119 @@ public:
 	///
 	/// Points are expected to be sorted in count clockwise order.
 	/// The 3rd dimensions is ignored and accepted as a parameter for compatibility reasons.
+	/// Memory is reserved for the triangulation of the polygon.
 	void initializeFromCCWVertices(const std::vector<glm::vec3> & vertices);
 
+	/// @brief Initializes the doubly connected edge list from a buffer of points representing a polygon.
+	/// @param positions A pointer to the x coordinate of the first point, followed by its y coordinate.
+	/// @param numVertices The number of points.
+	/// @param stride The distance in bytes between two consecutive points.
+	///
+	/// Meant for interleaved vertex buffers, other attributes are ignored.
+	/// For example, with an ofPolyline: `initializeFromCCWVertices(&polyline[0].x, polyline.size(), sizeof(glm::vec3))`.
+	/// Points are expected to be sorted in count clockwise order, they are read once.
+	/// If they are not, an error is thrown and the doubly connected edge list is left empty.
+	void initializeFromCCWVertices(const float * positions, std::size_t numVertices, std::size_t stride = sizeof(glm::vec2));
+
+	/// @brief Initializes the doubly connected edge list from separate arrays of coordinates representing a polygon.
+	/// @param xs The x coordinates of the points.
+	/// @param ys The y coordinates of the points.
+	/// @param numVertices The number of points.
+	///
+	/// Points are expected to be sorted in count clockwise order, they are read once.
+	/// If they are not, an error is thrown and the doubly connected edge list is left empty.
+	void initializeFromCCWVertices(const float * xs, const float * ys, std::size_t numVertices);
+
+	/// @brief Initializes the doubly connected edge list from a buffer of double precision points representing a polygon.
+	/// @param positions A pointer to the x coordinate of the first point, followed by its y coordinate.
+	/// @param numVertices The number of points.
+	/// @param stride The distance in bytes between two consecutive points.
+	///
+	/// Coordinates are converted to scalar_t, without loss if it is double.
+	void initializeFromCCWVertices(const double * positions, std::size_t numVertices, std::size_t stride = 2 * sizeof(double));
+
+	/// @brief Initializes the doubly connected edge list from separate arrays of double precision coordinates.
+	/// @param xs The x coordinates of the points.
+	/// @param ys The y coordinates of the points.
+	/// @param numVertices The number of points.
+	void initializeFromCCWVertices(const double * xs, const double * ys, std::size_t numVertices);
+
+	/// @brief Initializes the doubly connected edge list from a buffer of fixed point points representing a polygon.
+	/// @param positions A pointer to the x coordinate of the first point, followed by its y coordinate.
+	/// @param numVertices The number of points.
+	/// @param stride The distance in bytes between two consecutive points.
+	///
+	/// Coordinates are converted to scalar_t, without loss if it is std::int32_t.
+	void initializeFromCCWVertices(const std::int32_t * positions, std::size_t numVertices, std::size_t stride = 2 * sizeof(std::int32_t));
+
+	/// @brief Initializes the doubly connected edge list from separate arrays of fixed point coordinates.
+	/// @param xs The x coordinates of the points.
+	/// @param ys The y coordinates of the points.
+	/// @param numVertices The number of points.
+	void initializeFromCCWVertices(const std::int32_t * xs, const std::int32_t * ys, std::size_t numVertices);
+
+	/// @brief Returns the face assignment mode.
+	/// @return The face assignment mode.
+	inline FaceAssignment getFaceAssignment() const { return m_FaceAssignment; }
+
+	/// @brief Returns the stats filled by the doubly connected edge list, null if none.
+	inline ofPolygonTriangulationStats * getStats() const { return m_Stats; }
+
+	/// @brief Sets the stats filled by the doubly connected edge list.
+	/// @param stats The stats, which must outlive their use, or null to stop filling them.
+	///
+	/// Accounts for the winding check, extraction, diagonals, shared face lookups and face relabels.
+	/// Only filled when OF_POLYGON_TRIANGULATION_STATS is defined, see ofPolygonTriangulationStats.h.
+	inline void setStats(ofPolygonTriangulationStats * stats) { m_Stats = stats; }
+
+	/// @brief Sets the face assignment mode.
+	/// @param faceAssignment The face assignment mode.
+	///
+	/// Switching to immediate assignment assigns pending faces.
+	void setFaceAssignment(FaceAssignment faceAssignment);
+
+	/// @brief Assigns incident faces to half edges added since faces were last assigned.
+	///
+	/// Only needed in deferred mode, faces are then renumbered, the face holding the first half edge being the inner face.
+	/// Called automatically by the faces iterator, the vertex based half edge addition and triangles extraction.
+	/// Does nothing if faces are up to date.
+	void assignFaces();
+
 	/// @brief Adds an half edge connecting two vertices.
 	/// @param vertexA The first vertex.
 	/// @param vertexB The second vertex.
 	/// @return The newly created half edge.
-	HalfEdge addHalfEdge(Vertex & vertexA, Vertex & vertexB);
+	///
+	/// In deferred mode, pending faces are assigned first as we need them to find the face shared by the vertices.
+	HalfEdge addHalfEdge(const Vertex & vertexA, const Vertex & vertexB);
 
 	/// @brief Adds an half edge connecting two half edges.
 	/// @param edgeA The first half edge.
 	/// @param edgeB The second half edge.
 	/// @return The newly created half edge.
-	HalfEdge addHalfEdge(HalfEdge & edgeA, HalfEdge & edgeB);
+	///
+	/// Half edges are expected to lie on the same face.
+	/// In deferred mode, this is constant time but incident faces and face handles are stale until faces are assigned.
+	HalfEdge addHalfEdge(const HalfEdge & edgeA, const HalfEdge & edgeB);
+
+	/// @brief Allocates pairs of twin half edges, to be connected between half edges later on.
+	/// @param numPairs The number of pairs.
+	/// @return The first half edge, the pair i starting at its index + 2i.
+	///
+	/// Only valid in deferred mode.
+	/// Lets diagonals be added to distinct faces concurrently, see addHalfEdge(edgeA, edgeB, newEdge).
+	HalfEdge allocateHalfEdgePairs(std::size_t numPairs);
+
+	/// @brief Adds an half edge connecting two half edges, using a pair of half edges allocated beforehand.
+	/// @param edgeA The first half edge.
+	/// @param edgeB The second half edge.
+	/// @param newEdge The first half edge of an allocated pair, see allocateHalfEdgePairs().
+	/// @return The newly connected half edge, newEdge.
+	///
+	/// Only valid in deferred mode.
+	/// Only the half edges of the face and the new pair are written to,
+	/// so half edges may be added to distinct faces from different threads.
+	HalfEdge addHalfEdge(const HalfEdge & edgeA, const HalfEdge & edgeB, const HalfEdge & newEdge);
 
 	/// @brief Write the doubly connected edge list topology in arrays of vertices and indices.
 	/// @param vertices The geometry vertices.
@@ -209,6 +436,43 @@ public:
 	/// The doubly connected edge list must have been triangulated beforehand.
 	void extractTriangles(std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices);
 
+	/// @brief Returns the number of inner faces, which are triangles once the doubly connected edge list is triangulated.
+	/// @return The number of triangles.
+	///
+	/// Used to size index buffers, 3 indices per triangle.
+	std::size_t getNumTriangles();
+
+	/// @brief Writes the triangles indices to a caller provided buffer.
+	/// @param indices The buffer, holding at least 3 indices per triangle, see getNumTriangles().
+	/// @param baseVertex The offset added to each index, to pack several polygons in the same buffers.
+	///
+	/// Indices refer to the vertices as they were passed at initialization,
+	/// so the vertices need not be extracted if the caller already holds them.
+	/// Throws if the offset indices do not fit the index type.
+	void extractTriangles(unsigned int * indices, unsigned int baseVertex = 0);
+
+	/// @brief Writes the triangles indices to a caller provided buffer, using 16 bits indices.
+	/// @param indices The buffer, holding at least 3 indices per triangle, see getNumTriangles().
+	/// @param baseVertex The offset added to each index, to pack several polygons in the same buffers.
+	///
+	/// Throws if the offset indices do not fit 16 bits.
+	void extractTriangles(std::uint16_t * indices, std::uint16_t baseVertex = 0);
+
+	/// @brief Renumbers inner faces, which sets the order triangles are extracted in.
+	/// @param outerComponents The indices of one half edge of each inner face, getNumTriangles() of them, in the new order of faces.
+	///
+	/// Each half edge becomes the outer component of its face, triangles being extracted starting from its origin.
+	/// See ofOptimizeVertexCache for an order reusing vertices.
+	void reorderFaces(const index_t * outerComponents);
+
+	/// @brief Writes the vertices positions to a caller provided buffer.
+	/// @param positions A pointer to the x coordinate of the first point, followed by its y and z coordinates.
+	/// @param stride The distance in bytes between two consecutive points.
+	///
+	/// The buffer must hold getNumVertices() points, z is set to 0. Coordinates are converted to single precision.
+	/// Meant for interleaved vertex buffers, other attributes are left untouched.
+	void extractVertices(float * positions, std::size_t stride = sizeof(glm::vec3));
+
 	/// @brief Returns the index of the outer face.
 	constexpr static int getOuterFaceIndex() { return k_OuterFaceIndex; }
 
@@ -279,7 +543,9 @@ public:
 		FacesIterator(ofDoublyConnectedEdgeList & dcel)
 			: m_Dcel(&dcel)
 			, m_Current(Face(m_Dcel, k_InnerFaceIndex))
-			, m_Index(k_InnerFaceIndex) { }
+			, m_Index(k_InnerFaceIndex) {
+			dcel.assignFaces();
+		}
 		inline Face getCurrent() const { return m_Current; }
 		inline bool moveNext() {
 			if (m_Index < m_Dcel->m_FacesOuterComponent.size() - 1) {
@@ -0,0 +1,113 @@
+#include "ofEarClipping.h"
+#include "ofPolygonKernels.h"
+#include "ofPolygonPredicates.h"
+#include <stdexcept>
+
+// A vertex is an ear if it is convex and no other vertex of the remaining polygon lies within the triangle it forms with its neighbors.
+bool ofEarClipping::isEar(index_t index) const {
+	const auto prev = m_Prev[index];
+	const auto next = m_Next[index];
+	const auto a = m_Positions[prev];
+	const auto b = m_Positions[index];
+	const auto c = m_Positions[next];
+
+	if (ofOrient2d(a, b, c, m_RobustPredicates) <= 0.0) {
+		return false;
+	}
+
+	for (auto i = m_Next[next]; i != prev; i = m_Next[i]) {
+		const auto p = m_Positions[i];
+
+		// Vertices shared with the triangle, duplicates for example, do not prevent clipping.
+		if (p == a || p == b || p == c) {
+			continue;
+		}
+
+		if (ofOrient2d(a, b, p, m_RobustPredicates) >= 0.0
+			&& ofOrient2d(b, c, p, m_RobustPredicates) >= 0.0
+			&& ofOrient2d(c, a, p, m_RobustPredicates) >= 0.0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <class PositionAccessor>
+bool ofEarClipping::tryExecute(std::size_t numVertices, PositionAccessor getPosition, unsigned int * indices, unsigned int baseVertex) {
+	const auto len = numVertices;
+
+	if (len > ofDoublyConnectedEdgeList::getMaxNumVertices()) {
+		throw std::runtime_error("Too many vertices for the index type.");
+	}
+
+	m_Positions.resize(len);
+	m_Prev.resize(len);
+	m_Next.resize(len);
+
+	for (index_t i = 0; i != len; ++i) {
+		m_Positions[i] = getPosition(i);
+		m_Prev[i] = static_cast<index_t>((i + len - 1) % len);
+		m_Next[i] = static_cast<index_t>((i + 1) % len);
+	}
+
+	if (ofPolygonSignedArea(m_Positions.data(), len) <= 0) {
+		throw std::runtime_error("Passed vertices should be in counter clockwise order.");
+	}
+
+	auto remaining = len;
+	auto index = index_t { 0 };
+	// Number of vertices visited since an ear was last clipped.
+	auto numVisited = std::size_t { 0 };
+
+	while (remaining > 3) {
+		if (numVisited == remaining) {
+			return false;
+		}
+
+		if (!isEar(index)) {
+			index = m_Next[index];
+			++numVisited;
+			continue;
+		}
+
+		const auto prev = m_Prev[index];
+		const auto next = m_Next[index];
+
+		indices[0] = baseVertex + prev;
+		indices[1] = baseVertex + index;
+		indices[2] = baseVertex + next;
+		indices += 3;
+
+		m_Next[prev] = next;
+		m_Prev[next] = prev;
+		--remaining;
+
+		// Clipping an ear may only turn its neighbors into ears.
+		index = prev;
+		numVisited = 0;
+	}
+
+	indices[0] = baseVertex + m_Prev[index];
+	indices[1] = baseVertex + index;
+	indices[2] = baseVertex + m_Next[index];
+
+	return true;
+}
+
+bool ofEarClipping::tryExecute(const std::vector<glm::vec2> & vertices, unsigned int * indices, unsigned int baseVertex) {
+	return tryExecute(vertices.size(), [&vertices](index_t i) { return position_t(vertices[i].x, vertices[i].y); }, indices, baseVertex);
+}
+
+bool ofEarClipping::tryExecute(const std::vector<glm::vec3> & vertices, unsigned int * indices, unsigned int baseVertex) {
+	return tryExecute(vertices.size(), [&vertices](index_t i) { return position_t(vertices[i].x, vertices[i].y); }, indices, baseVertex);
+}
+
+bool ofEarClipping::tryExecute(const float * positions, std::size_t numVertices, std::size_t stride, unsigned int * indices, unsigned int baseVertex) {
+	const auto bytes = reinterpret_cast<const char *>(positions);
+	auto getPosition = [bytes, stride](index_t i) {
+		auto position = reinterpret_cast<const float *>(bytes + i * stride);
+		return position_t(position[0], position[1]);
+	};
+	return tryExecute(numVertices, getPosition, indices, baseVertex);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ofDoublyConnectedEdgeList.h"
+#include <vector>
+
+/// @brief A class implementing the triangulation of small polygons by ear clipping.
+///
+/// Works directly on the polygon vertices, without building a doubly connected edge list.
+/// Quadratic in the number of vertices, so only meant for small polygons.
+class ofEarClipping {
+public:
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	ofEarClipping() = default;
+
+	/// @brief Creates an instance allocating its scratch memory from a memory resource.
+	/// @param resource The memory resource, which must outlive the instance.
+	explicit ofEarClipping(ofPolygonMemoryResource * resource)
+		: m_Positions(resource)
+		, m_Prev(resource)
+		, m_Next(resource) { }
+#endif
+
+	/// @brief Tries to triangulate a polygon.
+	/// @param vertices The polygon points in counter clockwise order.
+	/// @param indices The buffer receiving the triangles indices, 3 per triangle, n - 2 triangles for n vertices.
+	/// @param baseVertex The offset added to each index.
+	/// @return Whether the polygon was triangulated, false if no ear could be found, for degenerate polygons for example.
+	///
+	/// Triangles are in counter clockwise order, indices refer to the passed vertices.
+	/// Throws if the points are not in counter clockwise order.
+	bool tryExecute(const std::vector<glm::vec2> & vertices, unsigned int * indices, unsigned int baseVertex = 0);
+
+	/// @brief Tries to triangulate a polygon.
+	/// @param vertices The polygon points in counter clockwise order.
+	/// @param indices The buffer receiving the triangles indices, 3 per triangle, n - 2 triangles for n vertices.
+	/// @param baseVertex The offset added to each index.
+	/// @return Whether the polygon was triangulated, false if no ear could be found, for degenerate polygons for example.
+	///
+	/// The 3rd dimensions is ignored and accepted as a parameter for compatibility reasons.
+	bool tryExecute(const std::vector<glm::vec3> & vertices, unsigned int * indices, unsigned int baseVertex = 0);
+
+	/// @brief Tries to triangulate a polygon read from a buffer of points.
+	/// @param positions A pointer to the x coordinate of the first point, followed by its y coordinate.
+	/// @param numVertices The number of points.
+	/// @param stride The distance in bytes between two consecutive points.
+	/// @param indices The buffer receiving the triangles indices, 3 per triangle, n - 2 triangles for n vertices.
+	/// @param baseVertex The offset added to each index.
+	/// @return Whether the polygon was triangulated, false if no ear could be found, for degenerate polygons for example.
+	bool tryExecute(const float * positions, std::size_t numVertices, std::size_t stride, unsigned int * indices, unsigned int baseVertex = 0);
+
+	/// @brief Sets whether geometric predicates are evaluated exactly.
+	/// @param robustPredicates True to use exact predicates, false by default.
+	inline void setRobustPredicates(bool robustPredicates) { m_RobustPredicates = robustPredicates; }
+
+	/// @brief Returns whether geometric predicates are evaluated exactly.
+	inline bool getRobustPredicates() const { return m_RobustPredicates; }
+
+private:
+	// The remaining polygon, as a circular doubly linked list of vertices.
+	ofPolygonVector<position_t> m_Positions;
+	ofPolygonVector<index_t> m_Prev;
+	ofPolygonVector<index_t> m_Next;
+	bool m_RobustPredicates { false };
+
+	bool isEar(index_t index) const;
+
+	// Private template, DRY but safe API.
+	// The accessor returns the position of a vertex given its index, each position is read once.
+	template <class PositionAccessor>
+	bool tryExecute(std::size_t numVertices, PositionAccessor getPosition, unsigned int * indices, unsigned int baseVertex);
+};
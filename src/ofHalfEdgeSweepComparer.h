@@ -1,22 +1,30 @@
 #pragma once
 
 #include "ofDoublyConnectedEdgeList.h"
+#include "ofPolygonPredicates.h"
 
 /// @brief A functor implementing the comparison of half edges.
 struct ofHalfEdgeSweepComparer {
 public:
+	/// @brief The type of intersections, floating point even for integer coordinates.
+	using point_t = glm::vec<2, ofPolygonReal_t<scalar_t>>;
+
 	/// @brief Determines the intersection of the sweep line and an half edge.
 	/// @param edge The half edge.
 	/// @param sweepY The sweep line coordinate.
 	/// @param found True if an intersection was found, false otherwise.
 	/// @return The intersection coordinates.
-	static glm::vec2 sweepIntersection(const ofDoublyConnectedEdgeList::HalfEdge & edge, float sweepY, bool & found) {
-		return sweepIntersection(edge.getOrigin().getPosition(), edge.getDestination().getPosition(), sweepY, found);
+	static point_t sweepIntersection(const ofDoublyConnectedEdgeList::HalfEdge & edge, scalar_t sweepY, bool & found) {
+		return sweepIntersection(
+			point_t(edge.getOrigin().getPosition()),
+			point_t(edge.getDestination().getPosition()),
+			static_cast<ofPolygonReal_t<scalar_t>>(sweepY),
+			found);
 	}
 
 	/// @brief Construct a functor with an initial sweep line coordinate.
 	/// @param sweepLineY The sweep line coordinate.
-	ofHalfEdgeSweepComparer(float sweepLineY)
+	ofHalfEdgeSweepComparer(scalar_t sweepLineY)
 		: m_SweepLineY(sweepLineY) { }
 
 	inline bool operator()(
@@ -29,14 +37,14 @@ public:
 	}
 
 private:
-	const float m_SweepLineY;
+	const scalar_t m_SweepLineY;
 
-	static glm::vec2 sweepIntersection(glm::vec2 origin, glm::vec2 destination, float sweepY, bool & found) {
+	static point_t sweepIntersection(point_t origin, point_t destination, ofPolygonReal_t<scalar_t> sweepY, bool & found) {
 		auto r = (origin.y - sweepY) / (origin.y - destination.y);
 
 		if (r > 1 || r < 0) {
 			found = false;
-			return glm::vec2(0.0f, 0.0f);
+			return point_t(0, 0);
 		}
 
 		found = true;
@@ -0,0 +1,146 @@
+#include "ofOptimizeVertexCache.h"
+#include <algorithm>
+
+void ofOptimizeVertexCache::reserve(std::size_t numVertices) {
+	// A triangulated polygon of n vertices has n - 2 triangles, n - 1 faces including the outer face.
+	m_NumLiveFaces.reserve(numVertices);
+	m_CacheTimes.reserve(numVertices);
+	m_IsFaceEmitted.reserve(numVertices);
+	m_DeadEnds.reserve(numVertices * 3);
+	// Faces around the fanned vertex, n - 2 for a fan, 3 vertices each.
+	m_Candidates.reserve(numVertices * 3);
+	m_FacesOrder.reserve(numVertices);
+}
+
+void ofOptimizeVertexCache::emitFaces(ofDoublyConnectedEdgeList & dcel, index_t vertex, std::size_t & time) {
+	m_Candidates.clear();
+
+	// Half edges leaving the vertex are circulated through the twins of the half edges reaching it.
+	const auto firstEdge = ofDoublyConnectedEdgeList::Vertex(&dcel, vertex).getIncidentEdge();
+	auto edge = firstEdge;
+	do {
+		const auto face = edge.getIncidentFace().getIndex();
+
+		if (face != ofDoublyConnectedEdgeList::getOuterFaceIndex() && !m_IsFaceEmitted[face]) {
+			m_IsFaceEmitted[face] = 1;
+			// Triangles start at the vertex being fanned out of.
+			m_FacesOrder.push_back(edge.getIndex());
+
+			auto faceEdge = edge;
+			do {
+				const auto faceVertex = faceEdge.getOrigin().getIndex();
+				m_DeadEnds.push_back(faceVertex);
+				m_Candidates.push_back(faceVertex);
+				--m_NumLiveFaces[faceVertex];
+
+				// Vertices out of the cache are transformed again.
+				if (time - m_CacheTimes[faceVertex] > m_CacheSize) {
+					m_CacheTimes[faceVertex] = time++;
+				}
+
+				faceEdge = faceEdge.getNext();
+			} while (faceEdge != edge);
+		}
+
+		edge = edge.getPrev().getTwin();
+	} while (edge != firstEdge);
+}
+
+index_t ofOptimizeVertexCache::getNextVertex(std::size_t time, index_t & scannedVertex) {
+	// Prefer the oldest neighbor that would still be cached once its remaining faces are emitted.
+	auto nextVertex = k_NoVertex;
+	auto maxPriority = std::size_t { 0 };
+	auto hasNextVertex = false;
+
+	for (auto vertex : m_Candidates) {
+		if (m_NumLiveFaces[vertex] == 0) {
+			continue;
+		}
+
+		auto priority = std::size_t { 0 };
+		if (time - m_CacheTimes[vertex] + 2 * m_NumLiveFaces[vertex] <= m_CacheSize) {
+			priority = time - m_CacheTimes[vertex];
+		}
+
+		if (!hasNextVertex || priority > maxPriority) {
+			nextVertex = vertex;
+			maxPriority = priority;
+			hasNextVertex = true;
+		}
+	}
+
+	if (hasNextVertex) {
+		return nextVertex;
+	}
+
+	// Dead end, fall back to recently used vertices, then to any vertex with faces left.
+	while (!m_DeadEnds.empty()) {
+		const auto vertex = m_DeadEnds.back();
+		m_DeadEnds.pop_back();
+		if (m_NumLiveFaces[vertex] != 0) {
+			return vertex;
+		}
+	}
+
+	for (; scannedVertex != m_NumLiveFaces.size(); ++scannedVertex) {
+		if (m_NumLiveFaces[scannedVertex] != 0) {
+			return scannedVertex;
+		}
+	}
+
+	return k_NoVertex;
+}
+
+void ofOptimizeVertexCache::execute(ofDoublyConnectedEdgeList & dcel) {
+	const auto numTriangles = dcel.getNumTriangles();
+	if (numTriangles < 2) {
+		return;
+	}
+
+	const auto numVertices = dcel.getNumVertices();
+	reserve(numVertices);
+
+	m_NumLiveFaces.assign(numVertices, 0);
+	m_CacheTimes.assign(numVertices, 0);
+	m_IsFaceEmitted.assign(numTriangles + 1, 0);
+	m_DeadEnds.clear();
+	m_FacesOrder.clear();
+
+	auto facesIterator = ofDoublyConnectedEdgeList::FacesIterator(dcel);
+	do {
+		auto halfEdgesIterator = ofDoublyConnectedEdgeList::HalfEdgesIterator(facesIterator.getCurrent());
+		do {
+			++m_NumLiveFaces[halfEdgesIterator.getCurrent().getOrigin().getIndex()];
+		} while (halfEdgesIterator.moveNext());
+	} while (facesIterator.moveNext());
+
+	// Starting past the cache size, so that no vertex is initially cached.
+	auto time = m_CacheSize + 1;
+	auto scannedVertex = index_t { 0 };
+
+	for (auto vertex = index_t { 0 }; vertex != k_NoVertex; vertex = getNextVertex(time, scannedVertex)) {
+		emitFaces(dcel, vertex, time);
+	}
+
+	dcel.reorderFaces(m_FacesOrder.data());
+}
+
+float ofOptimizeVertexCache::getAverageCacheMissRatio(const std::vector<unsigned int> & indices, std::size_t cacheSize) {
+	if (indices.size() < 3) {
+		return 0.0f;
+	}
+
+	// The time each vertex entered the cache, time being the number of misses, 0 if it never did.
+	const auto numVertices = static_cast<std::size_t>(*std::max_element(indices.begin(), indices.end())) + 1;
+	std::vector<std::size_t> cacheTimes(numVertices, 0);
+	auto numMisses = std::size_t { 0 };
+
+	for (auto index : indices) {
+		if (cacheTimes[index] == 0 || numMisses - cacheTimes[index] + 1 > cacheSize) {
+			++numMisses;
+			cacheTimes[index] = numMisses;
+		}
+	}
+
+	return static_cast<float>(numMisses) / static_cast<float>(indices.size() / 3);
+}
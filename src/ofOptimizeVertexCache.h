@@ -0,0 +1,75 @@
+#pragma once
+
+#include "ofDoublyConnectedEdgeList.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// @brief A class reordering the triangles of a doubly connected edge list for vertex reuse.
+///
+/// Triangles are otherwise extracted in the order faces were created, scattered across the polygon.
+/// Reordered, consecutive triangles share vertices, which the post transform vertex cache of GPUs reuses.
+/// Implements Tipsify, Sander et al. 2007, fanning out of vertices found by circulating around them through twins.
+class ofOptimizeVertexCache {
+public:
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	ofOptimizeVertexCache() = default;
+
+	/// @brief Creates an instance allocating its scratch memory from a memory resource.
+	/// @param resource The memory resource, which must outlive the instance.
+	explicit ofOptimizeVertexCache(ofPolygonMemoryResource * resource)
+		: m_NumLiveFaces(resource)
+		, m_CacheTimes(resource)
+		, m_IsFaceEmitted(resource)
+		, m_DeadEnds(resource)
+		, m_Candidates(resource)
+		, m_FacesOrder(resource) { }
+#endif
+
+	/// @brief Reorders the faces of a triangulated doubly connected edge list.
+	/// @param dcel The doubly connected edge list.
+	///
+	/// Linear in the number of triangles. Triangles are left unchanged, only their order and first vertex are,
+	/// see ofDoublyConnectedEdgeList::reorderFaces().
+	void execute(ofDoublyConnectedEdgeList & dcel);
+
+	/// @brief Reserves memory for polygons with up to a given number of vertices.
+	/// @param numVertices The number of vertices.
+	///
+	/// Once a polygon has been reordered, reordering polygons with as many vertices or less does not allocate memory.
+	void reserve(std::size_t numVertices);
+
+	/// @brief Sets the number of vertices the targeted vertex cache holds.
+	/// @param cacheSize The number of vertices, 16 by default.
+	inline void setCacheSize(std::size_t cacheSize) { m_CacheSize = cacheSize; }
+
+	/// @brief Returns the number of vertices the targeted vertex cache holds.
+	inline std::size_t getCacheSize() const { return m_CacheSize; }
+
+	/// @brief Returns the average number of vertices transformed per triangle, simulating a first in first out vertex cache.
+	/// @param indices The triangles indices, 3 per triangle.
+	/// @param cacheSize The number of vertices the cache holds.
+	/// @return The average cache miss ratio, from 0.5 for ideal large meshes to 3 without any reuse.
+	static float getAverageCacheMissRatio(const std::vector<unsigned int> & indices, std::size_t cacheSize = 16);
+
+private:
+	// The number of faces around each vertex not emitted yet.
+	ofPolygonVector<index_t> m_NumLiveFaces;
+	// The time each vertex last entered the cache, time being the number of vertices that entered it.
+	ofPolygonVector<std::size_t> m_CacheTimes;
+	ofPolygonVector<std::uint8_t> m_IsFaceEmitted;
+	// Vertices of emitted faces, most recent last, to pick a vertex to fan out of when the current one has no neighbor left.
+	ofPolygonVector<index_t> m_DeadEnds;
+	// Vertices of the faces emitted around the current vertex.
+	ofPolygonVector<index_t> m_Candidates;
+	// The outer component of each face, in the new order.
+	ofPolygonVector<index_t> m_FacesOrder;
+	std::size_t m_CacheSize { 16 };
+
+	// Emits the faces around a vertex not emitted yet.
+	void emitFaces(ofDoublyConnectedEdgeList & dcel, index_t vertex, std::size_t & time);
+	// Returns the next vertex to fan out of, or k_NoVertex once all faces are emitted.
+	index_t getNextVertex(std::size_t time, index_t & scannedVertex);
+
+	static constexpr index_t k_NoVertex = std::numeric_limits<index_t>::max();
+};
@@ -0,0 +1,185 @@
+#include "ofPolygonBatchTriangulation.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+// Polygons are claimed a few at a time, so that threads contend less on the shared counter
+// while threads done early still pick up work from slower ones.
+constexpr std::size_t k_PolygonsPerClaim = 16;
+
+ofPolygonBatchTriangulation::ofPolygonBatchTriangulation(std::size_t numThreads)
+	: m_NextPolygon(0) {
+	if (numThreads == 0) {
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	m_Workers.resize(numThreads);
+	startThreads();
+}
+
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+ofPolygonBatchTriangulation::ofPolygonBatchTriangulation(std::size_t numThreads, ofPolygonMemoryResource * resource)
+	: m_Workers(resource)
+	, m_Threads(resource)
+	, m_VertexOffsets(resource)
+	, m_IndexOffsets(resource)
+	, m_NextPolygon(0) {
+	if (numThreads == 0) {
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	m_Workers.reserve(numThreads);
+	for (std::size_t i = 0; i != numThreads; ++i) {
+		m_Workers.push_back({ ofPolygonTriangulation::Workspace(resource), nullptr });
+	}
+	startThreads();
+}
+#endif
+
+ofPolygonBatchTriangulation::~ofPolygonBatchTriangulation() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsStopping = true;
+	}
+	m_BatchStarted.notify_all();
+
+	for (auto & thread : m_Threads) {
+		thread.join();
+	}
+}
+
+void ofPolygonBatchTriangulation::startThreads() {
+	// The calling thread acts as the first worker.
+	m_Threads.reserve(m_Workers.size() - 1);
+	for (std::size_t i = 1; i < m_Workers.size(); ++i) {
+		m_Threads.emplace_back(&ofPolygonBatchTriangulation::runThread, this, i);
+	}
+}
+
+void ofPolygonBatchTriangulation::runThread(std::size_t workerIndex) {
+	auto numBatches = std::size_t { 0 };
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_BatchStarted.wait(lock, [&]() { return m_IsStopping || m_NumBatches != numBatches; });
+			if (m_IsStopping) {
+				return;
+			}
+			numBatches = m_NumBatches;
+		}
+
+		(this->*m_ExecuteWorker)(m_Workers[workerIndex]);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			--m_NumBusyThreads;
+		}
+		m_BatchDone.notify_one();
+	}
+}
+
+void ofPolygonBatchTriangulation::setRobustPredicates(bool robustPredicates) {
+	m_Options.robustPredicates = robustPredicates;
+}
+
+template <class vecN>
+void ofPolygonBatchTriangulation::executeWorker(Worker & worker) {
+	const auto & polygons = *static_cast<const std::vector<std::vector<vecN>> *>(m_Polygons);
+	const auto vertices = m_Vertices;
+	const auto indices = m_Indices;
+
+	try {
+		for (;;) {
+			const auto first = m_NextPolygon.fetch_add(k_PolygonsPerClaim);
+			if (first >= polygons.size()) {
+				return;
+			}
+
+			const auto last = std::min(first + k_PolygonsPerClaim, polygons.size());
+			for (auto i = first; i != last; ++i) {
+				if (m_VertexOffsets[i] == m_VertexOffsets[i + 1]) {
+					continue;
+				}
+
+				const auto & polygon = polygons[i];
+				ofPolygonTriangulation::triangulate(
+					polygon, indices + m_IndexOffsets[i], static_cast<unsigned int>(m_VertexOffsets[i]), worker.workspace, m_Options);
+
+				auto polygonVertices = vertices + m_VertexOffsets[i];
+				for (std::size_t j = 0; j != polygon.size(); ++j) {
+					polygonVertices[j] = glm::vec3(polygon[j].x, polygon[j].y, 0);
+				}
+			}
+		}
+	} catch (...) {
+		worker.error = std::current_exception();
+		// Let other threads stop early.
+		m_NextPolygon.store(polygons.size());
+	}
+}
+
+template <class vecN>
+void ofPolygonBatchTriangulation::execute(
+	const std::vector<std::vector<vecN>> & polygons, std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices) {
+	// A polygon of n vertices is triangulated in n - 2 triangles,
+	// so the location of each polygon in the packed buffers is known upfront.
+	m_VertexOffsets.resize(polygons.size() + 1);
+	m_IndexOffsets.resize(polygons.size() + 1);
+	m_VertexOffsets[0] = 0;
+	m_IndexOffsets[0] = 0;
+
+	for (std::size_t i = 0; i != polygons.size(); ++i) {
+		const auto numVertices = polygons[i].size();
+		const auto numTriangles = numVertices > 2 ? numVertices - 2 : 0;
+		m_VertexOffsets[i + 1] = m_VertexOffsets[i] + numVertices;
+		m_IndexOffsets[i + 1] = m_IndexOffsets[i] + numTriangles * 3;
+	}
+
+	if (m_VertexOffsets.back() > std::numeric_limits<unsigned int>::max()) {
+		throw std::runtime_error("Too many vertices for the index type.");
+	}
+
+	vertices.resize(m_VertexOffsets.back());
+	indices.resize(m_IndexOffsets.back());
+
+	m_NextPolygon.store(0);
+	m_Polygons = &polygons;
+	m_Vertices = vertices.data();
+	m_Indices = indices.data();
+	m_ExecuteWorker = &ofPolygonBatchTriangulation::executeWorker<vecN>;
+
+	// The mutex publishes the batch to threads.
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		++m_NumBatches;
+		m_NumBusyThreads = m_Threads.size();
+	}
+	m_BatchStarted.notify_all();
+
+	// The calling thread acts as the first worker.
+	executeWorker<vecN>(m_Workers[0]);
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_BatchDone.wait(lock, [this]() { return m_NumBusyThreads == 0; });
+	}
+
+	for (auto & worker : m_Workers) {
+		if (worker.error) {
+			auto error = worker.error;
+			for (auto & other : m_Workers) {
+				other.error = nullptr;
+			}
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+void ofPolygonBatchTriangulation::execute(
+	const std::vector<std::vector<glm::vec2>> & polygons, std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices) {
+	execute<glm::vec2>(polygons, vertices, indices);
+}
+
+void ofPolygonBatchTriangulation::execute(
+	const std::vector<std::vector<glm::vec3>> & polygons, std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices) {
+	execute<glm::vec3>(polygons, vertices, indices);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "ofDoublyConnectedEdgeList.h"
+#include "ofPolygonTriangulation.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief A class triangulating batches of polygons on several threads.
+///
+/// Threads are started once, on construction, and wait for batches in between, so that batches of small polygons
+/// do not pay for starting threads.
+class ofPolygonBatchTriangulation {
+public:
+	/// @brief Creates a batch triangulation.
+	/// @param numThreads The number of threads, 0 to use the number of hardware threads.
+	ofPolygonBatchTriangulation(std::size_t numThreads = 0);
+
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	/// @brief Creates a batch triangulation allocating all its memory from a memory resource.
+	/// @param numThreads The number of threads, 0 to use the number of hardware threads.
+	/// @param resource The memory resource, which must outlive the batch triangulation.
+	///
+	/// Threads allocate as they first meet larger polygons, so the resource must be thread safe with several threads,
+	/// a std::pmr::synchronized_pool_resource for example, possibly backed by a per frame arena.
+	ofPolygonBatchTriangulation(std::size_t numThreads, ofPolygonMemoryResource * resource);
+#endif
+
+	/// @brief Stops and joins the threads.
+	~ofPolygonBatchTriangulation();
+
+	ofPolygonBatchTriangulation(const ofPolygonBatchTriangulation &) = delete;
+	ofPolygonBatchTriangulation & operator=(const ofPolygonBatchTriangulation &) = delete;
+
+	/// @brief Returns the number of threads.
+	inline std::size_t getNumThreads() const { return m_Workers.size(); }
+
+	/// @brief Sets whether geometric predicates are evaluated exactly, see ofPolygonTriangulation::setRobustPredicates().
+	/// @param robustPredicates True to use exact predicates, false by default.
+	void setRobustPredicates(bool robustPredicates);
+
+	/// @brief Returns whether geometric predicates are evaluated exactly.
+	inline bool getRobustPredicates() const { return m_Options.robustPredicates; }
+
+	/// @brief Sets the number of vertices below which polygons are triangulated by ear clipping, see ofPolygonTriangulation::setSmallPolygonThreshold().
+	/// @param numVertices The number of vertices, 16 by default, 0 to always use a doubly connected edge list.
+	inline void setSmallPolygonThreshold(std::size_t numVertices) { m_Options.smallPolygonThreshold = numVertices; }
+
+	/// @brief Returns the number of vertices below which polygons are triangulated by ear clipping.
+	inline std::size_t getSmallPolygonThreshold() const { return m_Options.smallPolygonThreshold; }
+
+	/// @brief Sets whether triangles are reordered for vertex reuse, see ofPolygonTriangulation::setOptimizeVertexCache().
+	/// @param optimizeVertexCache True to reorder triangles, false by default.
+	inline void setOptimizeVertexCache(bool optimizeVertexCache) { m_Options.optimizeVertexCache = optimizeVertexCache; }
+
+	/// @brief Returns whether triangles are reordered for vertex reuse.
+	inline bool getOptimizeVertexCache() const { return m_Options.optimizeVertexCache; }
+
+	/// @brief Triangulates polygons, writing all triangles to the same geometry buffers.
+	/// @param polygons The polygons, each a vector of points in counter clockwise order.
+	/// @param vertices The geometry vertices of all polygons, one after the other.
+	/// @param indices The geometry indices of all polygons, one after the other.
+	///
+	/// Indices are offset so that they refer to the vertices of their polygon in the packed buffer,
+	/// see getVertexOffset() and getIndexOffset().
+	/// Polygons are distributed among threads dynamically, each thread keeps its own workspace, see ofPolygonTriangulation::triangulate().
+	/// Small polygons are triangulated by ear clipping, see setSmallPolygonThreshold().
+	/// If a polygon cannot be triangulated, the first error is thrown once all threads are done.
+	void execute(const std::vector<std::vector<glm::vec2>> & polygons, std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices);
+
+	/// @brief Triangulates polygons, writing all triangles to the same geometry buffers.
+	/// @param polygons The polygons, each a vector of points in counter clockwise order.
+	/// @param vertices The geometry vertices of all polygons, one after the other.
+	/// @param indices The geometry indices of all polygons, one after the other.
+	///
+	/// The 3rd dimensions is ignored and accepted as a parameter for compatibility reasons.
+	void execute(const std::vector<std::vector<glm::vec3>> & polygons, std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices);
+
+	/// @brief Returns the offset of the first vertex of a polygon in the packed vertices.
+	/// @param polygonIndex The index of the polygon in the last batch, the number of polygons yields the total.
+	inline std::size_t getVertexOffset(std::size_t polygonIndex) const { return m_VertexOffsets[polygonIndex]; }
+
+	/// @brief Returns the offset of the first index of a polygon in the packed indices.
+	/// @param polygonIndex The index of the polygon in the last batch, the number of polygons yields the total.
+	inline std::size_t getIndexOffset(std::size_t polygonIndex) const { return m_IndexOffsets[polygonIndex]; }
+
+private:
+	// Scratch memory owned by each thread, kept between batches.
+	struct Worker {
+		ofPolygonTriangulation::Workspace workspace;
+		std::exception_ptr error;
+	};
+
+	ofPolygonVector<Worker> m_Workers;
+	// Shared by all threads, read only while triangulating.
+	ofPolygonTriangulation::Options m_Options;
+	// Threads of all workers but the first, which is the calling thread.
+	ofPolygonVector<std::thread> m_Threads;
+	// One more entry than polygons, so that the last holds the totals.
+	ofPolygonVector<std::size_t> m_VertexOffsets;
+	ofPolygonVector<std::size_t> m_IndexOffsets;
+	// The next polygon to be claimed by a thread.
+	std::atomic<std::size_t> m_NextPolygon;
+
+	// The current batch, written by the calling thread before threads are woken up.
+	// The polygons are read by the worker function matching their type, so that a batch does not allocate.
+	const void * m_Polygons { nullptr };
+	glm::vec3 * m_Vertices { nullptr };
+	unsigned int * m_Indices { nullptr };
+	void (ofPolygonBatchTriangulation::*m_ExecuteWorker)(Worker & worker) { nullptr };
+
+	// Guards the batch counters below, threads wait for a new batch, the calling thread for all of them to be done.
+	std::mutex m_Mutex;
+	std::condition_variable m_BatchStarted;
+	std::condition_variable m_BatchDone;
+	std::size_t m_NumBatches { 0 };
+	std::size_t m_NumBusyThreads { 0 };
+	bool m_IsStopping { false };
+
+	void startThreads();
+	void runThread(std::size_t workerIndex);
+
+	// Private template, DRY but safe API.
+	template <class vecN>
+	void execute(const std::vector<std::vector<vecN>> & polygons, std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices);
+	template <class vecN>
+	void executeWorker(Worker & worker);
+};
@@ -0,0 +1,189 @@
+#include "ofPolygonKernels.h"
+#include <cstring>
+#include <type_traits>
+
+#if !defined(OF_POLYGON_TRIANGULATION_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define OF_POLYGON_TRIANGULATION_SSE2
+#include <emmintrin.h>
+#endif
+
+using VertexType = ofSplitToMonotone::VertexType;
+
+// Vectorized kernels read positions as interleaved coordinates.
+static_assert(sizeof(position_t) == 2 * sizeof(scalar_t), "Positions must be tightly packed.");
+
+// Vectorized kernels compute classifications as integers.
+static_assert(static_cast<int>(VertexType::Start) == 0 && static_cast<int>(VertexType::Stop) == 1
+		&& static_cast<int>(VertexType::Split) == 2 && static_cast<int>(VertexType::Merge) == 3
+		&& static_cast<int>(VertexType::Regular) == 4,
+	"Unexpected vertex type values.");
+
+// Whether vectorized kernels apply to the coordinates type.
+constexpr bool k_UseSimd =
+#ifdef OF_POLYGON_TRIANGULATION_SSE2
+	std::is_same<scalar_t, float>::value;
+#else
+	false;
+#endif
+
+// Sums the area of triangles fanning out of the first position, from first to last, excluded.
+ofPolygonProduct_t<scalar_t> signedAreaScalar(const position_t * positions, std::size_t first, std::size_t last) {
+	auto area = ofPolygonProduct_t<scalar_t>(0);
+
+	for (auto i = first; i != last; ++i) {
+		area += ofCross2d(positions[i] - positions[0], positions[i + 1] - positions[0]);
+	}
+
+	return area;
+}
+
+// Classifies vertices from first to last, excluded, wrapping around the polygon at both ends.
+bool classifyVerticesScalar(
+	const position_t * positions, std::size_t numVertices, std::size_t first, std::size_t last, VertexType * types, bool robustPredicates) {
+	auto isConvex = true;
+
+	for (auto i = first; i != last; ++i) {
+		const auto & prev = positions[i == 0 ? numVertices - 1 : i - 1];
+		const auto & vertex = positions[i];
+		const auto & next = positions[i + 1 == numVertices ? 0 : i + 1];
+
+		// As ofSplitToMonotone::classifyVertex.
+		const auto isTurnConvex = robustPredicates
+			? ofOrient2dAdaptive(prev, vertex, next) > 0.0
+			: ofCross2d(vertex - prev, next - vertex) > 0;
+
+		types[i] = ofSplitToMonotone::classifyTurn(prev, vertex, next, isTurnConvex);
+		isConvex &= isTurnConvex;
+	}
+
+	return isConvex;
+}
+
+#ifdef OF_POLYGON_TRIANGULATION_SSE2
+
+// Loads the coordinates of 4 consecutive positions, separating x and y.
+inline void loadPositions(const float * coordinates, __m128 & xs, __m128 & ys) {
+	const auto low = _mm_loadu_ps(coordinates);
+	const auto high = _mm_loadu_ps(coordinates + 4);
+	xs = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+	ys = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+// Whether the first positions come before the last ones along the sweep, as ofVertexSweepComparer.
+inline __m128 precedes(__m128 firstXs, __m128 firstYs, __m128 lastXs, __m128 lastYs) {
+	const auto sameY = _mm_and_ps(_mm_cmpeq_ps(firstYs, lastYs), _mm_cmplt_ps(firstXs, lastXs));
+	return _mm_or_ps(_mm_cmpgt_ps(firstYs, lastYs), sameY);
+}
+
+float signedAreaSse2(const float * coordinates, std::size_t numVertices, std::size_t & numProcessed) {
+	const auto originXs = _mm_set1_ps(coordinates[0]);
+	const auto originYs = _mm_set1_ps(coordinates[1]);
+	auto area = _mm_setzero_ps();
+
+	// Each lane accumulates the triangles fanning out of the first position, from position i to i + 1.
+	auto i = std::size_t { 0 };
+	for (; i + 5 <= numVertices; i += 4) {
+		__m128 xs, ys, nextXs, nextYs;
+		loadPositions(coordinates + 2 * i, xs, ys);
+		loadPositions(coordinates + 2 * (i + 1), nextXs, nextYs);
+
+		xs = _mm_sub_ps(xs, originXs);
+		ys = _mm_sub_ps(ys, originYs);
+		nextXs = _mm_sub_ps(nextXs, originXs);
+		nextYs = _mm_sub_ps(nextYs, originYs);
+
+		area = _mm_add_ps(area, _mm_sub_ps(_mm_mul_ps(xs, nextYs), _mm_mul_ps(ys, nextXs)));
+	}
+
+	numProcessed = i;
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, area);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+bool classifyVerticesSse2(const float * coordinates, std::size_t numVertices, VertexType * types, std::size_t & numProcessed) {
+	const auto start = _mm_set1_epi32(static_cast<int>(VertexType::Start));
+	const auto stop = _mm_set1_epi32(static_cast<int>(VertexType::Stop));
+	const auto split = _mm_set1_epi32(static_cast<int>(VertexType::Split));
+	const auto regular = _mm_set1_epi32(static_cast<int>(VertexType::Regular));
+	auto isConvex = true;
+
+	// Vertices 1 to n - 2, 4 at a time, the first and last ones wrap around the polygon.
+	auto i = std::size_t { 1 };
+	for (; i + 5 <= numVertices; i += 4) {
+		__m128 prevXs, prevYs, xs, ys, nextXs, nextYs;
+		loadPositions(coordinates + 2 * (i - 1), prevXs, prevYs);
+		loadPositions(coordinates + 2 * i, xs, ys);
+		loadPositions(coordinates + 2 * (i + 1), nextXs, nextYs);
+
+		// Same operations as ofCross2d(vertex - prev, next - vertex), so that results match the scalar path.
+		const auto turn = _mm_sub_ps(
+			_mm_mul_ps(_mm_sub_ps(xs, prevXs), _mm_sub_ps(nextYs, ys)),
+			_mm_mul_ps(_mm_sub_ps(ys, prevYs), _mm_sub_ps(nextXs, xs)));
+		const auto convex = _mm_cmpgt_ps(turn, _mm_setzero_ps());
+		isConvex &= _mm_movemask_ps(convex) == 0xF;
+
+		const auto compPrev = precedes(prevXs, prevYs, xs, ys);
+		const auto compNext = precedes(xs, ys, nextXs, nextYs);
+		const auto above = _mm_castps_si128(_mm_andnot_ps(compNext, compPrev));
+		const auto below = _mm_castps_si128(_mm_andnot_ps(compPrev, compNext));
+
+		// Start or Split when neighbors lie below, Stop or Merge, one more, when they lie above.
+		const auto belowType = _mm_or_si128(_mm_and_si128(_mm_castps_si128(convex), start), _mm_andnot_si128(_mm_castps_si128(convex), split));
+		const auto aboveType = _mm_add_epi32(belowType, stop);
+		auto type = _mm_or_si128(_mm_and_si128(below, belowType), _mm_and_si128(above, aboveType));
+		type = _mm_or_si128(type, _mm_andnot_si128(_mm_or_si128(above, below), regular));
+
+		// Narrow to bytes, values are small enough not to saturate.
+		const auto bytes = _mm_packus_epi16(_mm_packs_epi32(type, type), _mm_setzero_si128());
+		const auto packed = _mm_cvtsi128_si32(bytes);
+		std::memcpy(types + i, &packed, 4);
+	}
+
+	numProcessed = i;
+	return isConvex;
+}
+
+#endif
+
+ofPolygonProduct_t<scalar_t> ofPolygonSignedArea(const position_t * positions, std::size_t numVertices) {
+	if (numVertices < 3) {
+		return ofPolygonProduct_t<scalar_t>(0);
+	}
+
+	auto area = ofPolygonProduct_t<scalar_t>(0);
+	auto numProcessed = std::size_t { 0 };
+
+#ifdef OF_POLYGON_TRIANGULATION_SSE2
+	if constexpr (k_UseSimd) {
+		area = signedAreaSse2(reinterpret_cast<const float *>(positions), numVertices, numProcessed);
+	}
+#endif
+
+	// The closing edge leads back to the first position, its triangle is empty.
+	return area + signedAreaScalar(positions, numProcessed, numVertices - 1);
+}
+
+bool ofPolygonClassifyVertices(const position_t * positions, std::size_t numVertices, VertexType * types, bool robustPredicates) {
+	if (robustPredicates || !k_UseSimd) {
+		return classifyVerticesScalar(positions, numVertices, 0, numVertices, types, robustPredicates);
+	}
+
+	auto isConvex = true;
+	auto numProcessed = std::size_t { 1 };
+
+#ifdef OF_POLYGON_TRIANGULATION_SSE2
+	if constexpr (k_UseSimd) {
+		isConvex = classifyVerticesSse2(reinterpret_cast<const float *>(positions), numVertices, types, numProcessed);
+	}
+#endif
+
+	isConvex &= classifyVerticesScalar(positions, numVertices, 0, 1, types, false);
+	isConvex &= classifyVerticesScalar(positions, numVertices, numProcessed, numVertices, types, false);
+	return isConvex;
+}
+
+const char * ofPolygonKernelsInstructionSet() {
+	return k_UseSimd ? "SSE2" : "Scalar";
+}
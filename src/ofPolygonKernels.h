@@ -0,0 +1,30 @@
+/// \file ofPolygonKernels.h
+
+#pragma once
+
+#include "ofDoublyConnectedEdgeList.h"
+#include "ofPolygonPredicates.h"
+#include "ofSplitToMonotone.h"
+
+// Dense passes over the positions of a polygon, its vertices being contiguous in order.
+// Single precision coordinates are processed 4 at a time with SSE2 where available,
+// define OF_POLYGON_TRIANGULATION_NO_SIMD to always use the scalar implementation.
+
+/// @brief Returns twice the signed area of a polygon.
+/// @param positions The positions of the vertices, in order along the polygon.
+/// @param numVertices The number of vertices.
+/// @return Positive if the vertices are in counter clockwise order.
+///
+/// Positions are taken relative to the first one, which keeps rounding in check for large coordinates.
+ofPolygonProduct_t<scalar_t> ofPolygonSignedArea(const position_t * positions, std::size_t numVertices);
+
+/// @brief Classifies all the vertices of a polygon for splitting to monotone.
+/// @param positions The positions of the vertices, in order along the polygon.
+/// @param numVertices The number of vertices, at least 3.
+/// @param types Receives the classification of each vertex, as ofSplitToMonotone::classifyVertex.
+/// @param robustPredicates Whether turns are evaluated exactly, which is done one vertex at a time.
+/// @return Whether the polygon is strictly convex.
+bool ofPolygonClassifyVertices(const position_t * positions, std::size_t numVertices, ofSplitToMonotone::VertexType * types, bool robustPredicates = false);
+
+/// @brief Returns the name of the instruction set kernels use, "SSE2" or "Scalar".
+const char * ofPolygonKernelsInstructionSet();
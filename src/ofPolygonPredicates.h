@@ -0,0 +1,135 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Orientation predicates shared by the triangulation steps.
+// They only compare signs or orders, so there is no need to normalize vectors or evaluate angles.
+// They are templated on the coordinates type, see OF_POLYGON_TRIANGULATION_SCALAR_TYPE,
+// and specialized at compile time for integer coordinates, with which they are exact.
+
+/// @brief The type of products of coordinates, 64 bits integers for integer coordinates so that they are exact.
+template <class T>
+using ofPolygonProduct_t = typename std::conditional<std::is_integral<T>::value, std::int64_t, T>::type;
+
+/// @brief The floating point type of measures derived from coordinates, such as angles.
+template <class T>
+using ofPolygonReal_t = typename std::conditional<std::is_integral<T>::value, float, T>::type;
+
+/// @brief Returns the 2d cross product of two vectors.
+///
+/// Positive if the shortest rotation from the first vector to the second is counter clockwise,
+/// zero if they are collinear. This is the sign of their oriented angle.
+template <class T, glm::qualifier Q>
+inline ofPolygonProduct_t<T> ofCross2d(const glm::vec<2, T, Q> & u, const glm::vec<2, T, Q> & v) {
+	using product_t = ofPolygonProduct_t<T>;
+	return static_cast<product_t>(u.x) * v.y - static_cast<product_t>(u.y) * v.x;
+}
+
+/// @brief Returns twice the signed area of a triangle.
+///
+/// Positive if the vertices are in counter clockwise order, zero if they are collinear.
+template <class T, glm::qualifier Q>
+inline ofPolygonProduct_t<T> ofOrient2d(const glm::vec<2, T, Q> & a, const glm::vec<2, T, Q> & b, const glm::vec<2, T, Q> & c) {
+	return ofCross2d(b - a, c - a);
+}
+
+/// @brief Returns a value whose sign is the exact orientation of a triangle.
+///
+/// Positive if the vertices are in counter clockwise order, zero if they are collinear, as ofOrient2d.
+/// The determinant is evaluated in double precision along with a bound of its rounding error,
+/// which decides its sign in all but nearly degenerate cases. Others fall back to exact arithmetic.
+/// Integer coordinates need neither, ofOrient2d is exact for them.
+template <class T, glm::qualifier Q>
+inline double ofOrient2dAdaptive(const glm::vec<2, T, Q> & a, const glm::vec<2, T, Q> & b, const glm::vec<2, T, Q> & c) {
+	if constexpr (std::is_integral<T>::value) {
+		return static_cast<double>(ofOrient2d(a, b, c));
+	} else {
+		const auto detLeft = (static_cast<double>(a.x) - c.x) * (static_cast<double>(b.y) - c.y);
+		const auto detRight = (static_cast<double>(a.y) - c.y) * (static_cast<double>(b.x) - c.x);
+		const auto det = detLeft - detRight;
+
+		// Error bound of the double precision determinant, see Shewchuk, Adaptive Precision Floating-Point Arithmetic.
+		const auto epsilon = std::numeric_limits<double>::epsilon() * 0.5;
+		const auto errorBound = (3.0 + 16.0 * epsilon) * epsilon * (std::abs(detLeft) + std::abs(detRight));
+
+		if (det > errorBound || -det > errorBound) {
+			return det;
+		}
+
+		// The determinant is the sum of products of coordinates,
+		// accumulated without rounding as an expansion of non overlapping components.
+		double expansion[12];
+		auto numComponents = 0;
+
+		auto grow = [&expansion, &numComponents](double component) {
+			for (auto i = 0; i != numComponents; ++i) {
+				// Two sum, the rounded sum and its exact rounding error.
+				const auto rounded = component + expansion[i];
+				const auto virtualComponent = rounded - component;
+				const auto virtualSum = rounded - virtualComponent;
+				expansion[i] = (component - virtualSum) + (expansion[i] - virtualComponent);
+				component = rounded;
+			}
+			expansion[numComponents++] = component;
+		};
+
+		auto growProduct = [&grow](double x, double y) {
+			const auto product = x * y;
+			grow(product);
+			// Products of single precision coordinates are exact in double precision,
+			// others are completed by their rounding error, which a fused multiply add yields exactly.
+			if constexpr (!std::is_same<T, float>::value) {
+				grow(std::fma(x, y, -product));
+			}
+		};
+
+		growProduct(a.x, b.y);
+		growProduct(-static_cast<double>(a.x), c.y);
+		growProduct(b.x, c.y);
+		growProduct(-static_cast<double>(b.x), a.y);
+		growProduct(c.x, a.y);
+		growProduct(-static_cast<double>(c.x), b.y);
+
+		// Components are sorted by increasing magnitude, the largest non zero one carries the sign.
+		for (auto i = numComponents; i-- != 0;) {
+			if (expansion[i] != 0.0) {
+				return expansion[i];
+			}
+		}
+
+		return 0.0;
+	}
+}
+
+/// @brief Returns a value whose sign is the orientation of a triangle.
+/// @param robust Whether the sign should be exact, see ofOrient2dAdaptive, rather than subject to rounding, see ofOrient2d.
+template <class T, glm::qualifier Q>
+inline double ofOrient2d(const glm::vec<2, T, Q> & a, const glm::vec<2, T, Q> & b, const glm::vec<2, T, Q> & c, bool robust) {
+	return robust ? ofOrient2dAdaptive(a, b, c) : static_cast<double>(ofOrient2d(a, b, c));
+}
+
+/// @brief Returns a value growing monotonically with the counter clockwise angle from one vector to another.
+///
+/// The value lies in [0, 4), for an angle in [0, 2PI).
+/// Meant to compare angles without evaluating them.
+template <class T, glm::qualifier Q>
+inline ofPolygonReal_t<T> ofPseudoAngle(const glm::vec<2, T, Q> & u, const glm::vec<2, T, Q> & v) {
+	using product_t = ofPolygonProduct_t<T>;
+	using real_t = ofPolygonReal_t<T>;
+
+	const auto cross = static_cast<real_t>(ofCross2d(u, v));
+	const auto dot = static_cast<real_t>(static_cast<product_t>(u.x) * v.x + static_cast<product_t>(u.y) * v.y);
+	const auto sum = std::abs(cross) + std::abs(dot);
+
+	if (sum == real_t(0)) {
+		return real_t(0);
+	}
+
+	// Position along a diamond rather than a circle, in [0, 2] on the upper half and in [2, 4) on the lower half.
+	const auto ratio = dot / sum;
+	return cross >= real_t(0) ? real_t(1) - ratio : real_t(3) + ratio;
+}
@@ -1,5 +1,11 @@
 #include "ofPolygonTriangulation.h"
-#include <glm/gtx/vector_angle.hpp>
+#include "ofPolygonKernels.h"
+#include "ofPolygonPredicates.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <thread>
 
 // Used to identify trivial polygons.
 enum class FaceType {
@@ -30,6 +36,113 @@ FaceType getFaceType(ofDoublyConnectedEdgeList::Face face) {
 	return FaceType::Polygon;
 }
 
+// Detects convex and monotone polygons in a single pass over the vertices.
+ofPolygonTriangulation::Path classifyPolygon(
+	ofDoublyConnectedEdgeList & dcel, bool robustPredicates, ofPolygonVector<ofSplitToMonotone::VertexType> & verticesClassification) {
+	// The initial polygon is classified in a dense pass over positions.
+	if (dcel.isInitialPolygon()) {
+		verticesClassification.resize(dcel.getNumVertices());
+		const auto isConvex = ofPolygonClassifyVertices(dcel.getPositions(), dcel.getNumVertices(), verticesClassification.data(), robustPredicates);
+
+		for (auto type : verticesClassification) {
+			if (type == ofSplitToMonotone::VertexType::Split || type == ofSplitToMonotone::VertexType::Merge) {
+				return ofPolygonTriangulation::Path::SplitToMonotone;
+			}
+		}
+
+		return isConvex ? ofPolygonTriangulation::Path::Convex : ofPolygonTriangulation::Path::Monotone;
+	}
+
+	auto face = dcel.getInnerFace();
+	auto isConvex = true;
+	auto halfEdgesIterator = ofDoublyConnectedEdgeList::HalfEdgesIterator(face);
+
+	do {
+		auto edge = halfEdgesIterator.getCurrent();
+		auto vertex = edge.getOrigin();
+
+		// Vertex classification relies on incident edges lying on the face.
+		vertex.setIncidentEdge(edge);
+
+		switch (ofSplitToMonotone::classifyVertex(vertex, robustPredicates)) {
+		case ofSplitToMonotone::VertexType::Split:
+		case ofSplitToMonotone::VertexType::Merge:
+			return ofPolygonTriangulation::Path::SplitToMonotone;
+		default:
+			break;
+		}
+
+		if (isConvex) {
+			// Collinear vertices would lead to degenerate triangles in a fan.
+			isConvex = robustPredicates
+				? ofOrient2dAdaptive(edge.getPrev().getOrigin().getPosition(), vertex.getPosition(), edge.getDestination().getPosition()) > 0.0
+				: ofCross2d(edge.getPrev().getDirection(), edge.getDirection()) > 0.0f;
+		}
+
+	} while (halfEdgesIterator.moveNext());
+
+	return isConvex ? ofPolygonTriangulation::Path::Convex : ofPolygonTriangulation::Path::Monotone;
+}
+
+void triangulateConvex(ofDoublyConnectedEdgeList & dcel, ofDoublyConnectedEdgeList::Face face) {
+	// Fan out of the origin of the outer component,
+	// each diagonal cutting a triangle off the remaining polygon, which the diagonal belongs to.
+	auto fanEdge = face.getOuterComponent();
+	auto edge = fanEdge.getNext().getNext();
+
+	while (edge.getNext() != fanEdge) {
+		fanEdge = dcel.addHalfEdge(fanEdge, edge);
+		edge = edge.getNext();
+	}
+}
+
+// Attaches stats to a doubly connected edge list for the duration of a triangulation, unless it has its own.
+class DcelStatsAttachment {
+public:
+	DcelStatsAttachment(ofDoublyConnectedEdgeList & dcel, ofPolygonTriangulationStats * stats)
+		: m_Dcel(dcel)
+		, m_IsAttached(dcel.getStats() == nullptr) {
+		if (m_IsAttached) {
+			m_Dcel.setStats(stats);
+		}
+	}
+
+	~DcelStatsAttachment() {
+		if (m_IsAttached) {
+			m_Dcel.setStats(nullptr);
+		}
+	}
+
+	DcelStatsAttachment(const DcelStatsAttachment &) = delete;
+	DcelStatsAttachment & operator=(const DcelStatsAttachment &) = delete;
+
+private:
+	ofDoublyConnectedEdgeList & m_Dcel;
+	const bool m_IsAttached;
+};
+
+// Defers face assignment for the duration of a triangulation, restoring the mode of the caller even if it throws.
+class DcelFaceAssignmentScope {
+public:
+	explicit DcelFaceAssignmentScope(ofDoublyConnectedEdgeList & dcel)
+		: m_Dcel(dcel)
+		, m_FaceAssignment(dcel.getFaceAssignment()) {
+		m_Dcel.setFaceAssignment(ofDoublyConnectedEdgeList::FaceAssignment::Deferred);
+	}
+
+	// Faces are assigned here if the caller expects immediate assignment.
+	~DcelFaceAssignmentScope() {
+		m_Dcel.setFaceAssignment(m_FaceAssignment);
+	}
+
+	DcelFaceAssignmentScope(const DcelFaceAssignmentScope &) = delete;
+	DcelFaceAssignmentScope & operator=(const DcelFaceAssignmentScope &) = delete;
+
+private:
+	ofDoublyConnectedEdgeList & m_Dcel;
+	const ofDoublyConnectedEdgeList::FaceAssignment m_FaceAssignment;
+};
+
 void triangulateQuad(ofDoublyConnectedEdgeList & dcel, ofDoublyConnectedEdgeList::Face face) {
 	// Find maximal inner angle.
 	auto maxInnerAngleEdge = ofDoublyConnectedEdgeList::HalfEdge();
@@ -39,15 +152,284 @@ void triangulateQuad(ofDoublyConnectedEdgeList & dcel, ofDoublyConnectedEdgeList
 	dcel.addHalfEdge(maxInnerAngleEdge, maxInnerAngleEdge.getNext().getNext());
 }
 
-void ofPolygonTriangulation::execute(ofDoublyConnectedEdgeList & dcel) {
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+ofPolygonTriangulation::Workspace::Workspace(ofPolygonMemoryResource * resource)
+	: m_SplitToMonotone(resource)
+	, m_TriangulateMonotone(resource)
+	, m_FacesPendingTriangulation(resource)
+	, m_VerticesClassification(resource)
+	, m_FacesFirstEdgePair(resource)
+	, m_EarClipping(resource)
+	, m_Dcel(resource)
+	, m_OptimizeVertexCache(resource) { }
+
+ofPolygonTriangulation::ofPolygonTriangulation(ofPolygonMemoryResource * resource)
+	: m_Workspace(resource)
+	, m_MonotoneWorkers(resource) { }
+
+ofPolygonTriangulation::MonotoneWorkers::MonotoneWorkers(ofPolygonMemoryResource * resource)
+	: m_TriangulateMonotone(resource)
+	, m_Threads(resource)
+	, m_Errors(resource) { }
+#endif
+
+void ofPolygonTriangulation::Workspace::reserve(std::size_t numVertices) {
+	m_SplitToMonotone.reserve(numVertices);
+	m_TriangulateMonotone.reserve(numVertices);
+	// A polygon is split in at most n - 2 faces.
+	m_FacesPendingTriangulation.reserve(numVertices);
+	m_VerticesClassification.reserve(numVertices);
+}
+
+void ofPolygonTriangulation::reserve(std::size_t numVertices) {
+	m_Workspace.reserve(numVertices);
+
+	if (m_MonotoneWorkers.getNumThreads() != 0) {
+		m_Workspace.m_FacesFirstEdgePair.reserve(numVertices);
+		m_MonotoneWorkers.reserve(numVertices);
+	}
+}
+
+void ofPolygonTriangulation::setNumThreads(std::size_t numThreads) {
+	if (numThreads == 0) {
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	m_MonotoneWorkers.setNumThreads(numThreads - 1);
+	m_MonotoneWorkers.setRobustPredicates(m_Options.robustPredicates);
+}
+
+void ofPolygonTriangulation::setRobustPredicates(bool robustPredicates) {
+	// The workspace is set up on each triangulation, workers are not part of it.
+	m_Options.robustPredicates = robustPredicates;
+	m_MonotoneWorkers.setRobustPredicates(robustPredicates);
+}
+
+ofPolygonTriangulation::MonotoneWorkers::~MonotoneWorkers() {
+	stopThreads();
+}
+
+void ofPolygonTriangulation::MonotoneWorkers::stopThreads() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsStopping = true;
+	}
+	m_RunStarted.notify_all();
+
+	for (auto & thread : m_Threads) {
+		thread.join();
+	}
+
+	m_Threads.clear();
+	m_IsStopping = false;
+}
+
+void ofPolygonTriangulation::MonotoneWorkers::setNumThreads(std::size_t numThreads) {
+	if (numThreads == m_Threads.size()) {
+		return;
+	}
+
+	stopThreads();
+
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	// Workers allocate from the memory resource of this instance, resizing would use the default one.
+	while (m_TriangulateMonotone.size() < numThreads) {
+		m_TriangulateMonotone.emplace_back(m_TriangulateMonotone.get_allocator().resource());
+	}
+#endif
+	m_TriangulateMonotone.resize(numThreads);
+	// Sized upfront, so that runs do not allocate.
+	m_Errors.resize(numThreads + 1);
+
+	m_Threads.reserve(numThreads);
+	for (std::size_t i = 0; i != numThreads; ++i) {
+		m_Threads.emplace_back(&MonotoneWorkers::runThread, this, i);
+	}
+}
+
+void ofPolygonTriangulation::MonotoneWorkers::reserve(std::size_t numVertices) {
+	for (auto & triangulateMonotone : m_TriangulateMonotone) {
+		triangulateMonotone.reserve(numVertices);
+	}
+}
+
+void ofPolygonTriangulation::MonotoneWorkers::setRobustPredicates(bool robustPredicates) {
+	for (auto & triangulateMonotone : m_TriangulateMonotone) {
+		triangulateMonotone.setRobustPredicates(robustPredicates);
+	}
+}
+
+void ofPolygonTriangulation::MonotoneWorkers::runThread(std::size_t threadIndex) {
+	auto numRuns = std::size_t { 0 };
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_RunStarted.wait(lock, [&]() { return m_IsStopping || m_NumRuns != numRuns; });
+			if (m_IsStopping) {
+				return;
+			}
+			numRuns = m_NumRuns;
+		}
+
+		triangulate(m_TriangulateMonotone[threadIndex], m_Errors[threadIndex]);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			--m_NumBusyThreads;
+		}
+		m_RunDone.notify_one();
+	}
+}
+
+// Faces are claimed one at a time, as their sizes vary widely.
+void ofPolygonTriangulation::MonotoneWorkers::triangulate(ofTriangulateMonotone & triangulateMonotone, std::exception_ptr & error) {
+	try {
+		for (auto i = m_NextFace.fetch_add(1); i < m_NumFaces; i = m_NextFace.fetch_add(1)) {
+			auto firstEdge = ofDoublyConnectedEdgeList::HalfEdge(m_Dcel, m_FirstEdgePair + m_FacesFirstEdgePair[i] * 2);
+			triangulateMonotone.execute(*m_Dcel, m_Faces[i], firstEdge);
+		}
+	} catch (...) {
+		error = std::current_exception();
+		// Let other threads stop early.
+		m_NextFace.store(m_NumFaces);
+	}
+}
+
+void ofPolygonTriangulation::MonotoneWorkers::execute(ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face * faces,
+	const index_t * facesFirstEdgePair, std::size_t numFaces, index_t firstEdgePair, ofTriangulateMonotone & triangulateMonotone) {
+	m_Dcel = &dcel;
+	m_Faces = faces;
+	m_FacesFirstEdgePair = facesFirstEdgePair;
+	m_NumFaces = numFaces;
+	m_FirstEdgePair = firstEdgePair;
+	m_NextFace.store(0);
+
+	// The mutex publishes the run to threads.
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		++m_NumRuns;
+		m_NumBusyThreads = m_Threads.size();
+	}
+	m_RunStarted.notify_all();
+
+	// The calling thread acts as a worker too.
+	triangulate(triangulateMonotone, m_Errors.back());
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_RunDone.wait(lock, [this]() { return m_NumBusyThreads == 0; });
+	}
+
+	for (auto & error : m_Errors) {
+		if (error) {
+			auto firstError = error;
+			for (auto & other : m_Errors) {
+				other = nullptr;
+			}
+			std::rethrow_exception(firstError);
+		}
+	}
+}
+
+std::size_t getNumVertices(ofDoublyConnectedEdgeList::Face face) {
+	auto numVertices = std::size_t { 0 };
+	auto halfEdgesIterator = ofDoublyConnectedEdgeList::HalfEdgesIterator(face);
+	do {
+		++numVertices;
+	} while (halfEdgesIterator.moveNext());
+	return numVertices;
+}
+
+void ofPolygonTriangulation::triangulatePendingFacesConcurrently(
+	ofDoublyConnectedEdgeList & dcel, Workspace & workspace, MonotoneWorkers & workers) {
+	auto & facesPendingTriangulation = workspace.m_FacesPendingTriangulation;
+	auto & facesFirstEdgePair = workspace.m_FacesFirstEdgePair;
+
+	// Diagonals of a face of n vertices are n - 3 pairs of half edges, allocated upfront.
+	// Faces are allotted consecutive pairs in the order they would be triangulated by a single thread,
+	// so that the resulting doubly connected edge list does not depend on the number of threads.
+	const auto numFaces = facesPendingTriangulation.size();
+	facesFirstEdgePair.resize(numFaces);
+
+	auto numPairs = std::size_t { 0 };
+	for (auto i = numFaces; i-- != 0;) {
+		facesFirstEdgePair[i] = static_cast<index_t>(numPairs);
+		numPairs += getNumVertices(facesPendingTriangulation[i]) - 3;
+	}
+
+	const auto firstEdgePair = dcel.allocateHalfEdgePairs(numPairs).getIndex();
+
+	// Faces are cleared even if triangulation throws.
+	try {
+		workers.execute(dcel, facesPendingTriangulation.data(), facesFirstEdgePair.data(), numFaces, firstEdgePair, workspace.m_TriangulateMonotone);
+	} catch (...) {
+		facesPendingTriangulation.clear();
+		throw;
+	}
+	facesPendingTriangulation.clear();
+}
+
+ofPolygonTriangulation::Path ofPolygonTriangulation::triangulate(
+	ofDoublyConnectedEdgeList & dcel, Workspace & workspace, const Options & options, MonotoneWorkers * workers) {
+	auto & splitToMonotone = workspace.m_SplitToMonotone;
+	auto & triangulateMonotone = workspace.m_TriangulateMonotone;
+	auto & facesPendingTriangulation = workspace.m_FacesPendingTriangulation;
+	auto * stats = options.stats;
+
+	// A workspace may have been used with other options.
+	splitToMonotone.setRobustPredicates(options.robustPredicates);
+	splitToMonotone.setStats(stats);
+	triangulateMonotone.setRobustPredicates(options.robustPredicates);
+
+	const auto numVertices = dcel.getNumVertices();
+	workspace.reserve(numVertices);
+	// Small polygons are triangulated on the calling thread, waking threads up would cost more.
+	const auto isConcurrent = workers != nullptr && workers->getNumThreads() != 0 && numVertices >= workers->getThreshold();
+	if (isConcurrent) {
+		workspace.m_FacesFirstEdgePair.reserve(numVertices);
+		workers->reserve(numVertices);
+	}
+
+	const auto statsAttachment = DcelStatsAttachment(dcel, stats);
+	// Diagonals are added between half edges, faces are assigned once when needed.
+	const auto faceAssignmentScope = DcelFaceAssignmentScope(dcel);
+
 	auto innerFace = dcel.getInnerFace();
-	m_SplitToMonotone.execute(dcel, innerFace);
+	auto path = Path::SplitToMonotone;
+	{
+		OF_POLYGON_STATS_SCOPE(stats, classification);
+		path = classifyPolygon(dcel, options.robustPredicates, workspace.m_VerticesClassification);
+	}
+
+	switch (path) {
+	case Path::Convex: {
+		OF_POLYGON_STATS_SCOPE(stats, monotoneTriangulation);
+		OF_POLYGON_STATS_ADD(stats, numMonotonePolygons, 1);
+		triangulateConvex(dcel, innerFace);
+		return path;
+	}
+	case Path::Monotone: {
+		OF_POLYGON_STATS_SCOPE(stats, monotoneTriangulation);
+		OF_POLYGON_STATS_ADD(stats, numMonotonePolygons, 1);
+		triangulateMonotone.execute(dcel, innerFace);
+		return path;
+	}
+	default:
+		// The initial polygon was classified in full, the split reuses it.
+		if (dcel.isInitialPolygon()) {
+			splitToMonotone.execute(dcel, innerFace, workspace.m_VerticesClassification.data());
+		} else {
+			splitToMonotone.execute(dcel, innerFace);
+		}
+	}
+
+	OF_POLYGON_STATS_SCOPE(stats, monotoneTriangulation);
 
 	auto facesIterator = ofDoublyConnectedEdgeList::FacesIterator(dcel);
 
 	do {
 		auto face = facesIterator.getCurrent();
-		
+		OF_POLYGON_STATS_ADD(stats, numMonotonePolygons, 1);
+
 		switch (getFaceType(face)) {
 		case FaceType::Triangle:
 			// Bypass already triangulated faces.
@@ -56,22 +438,86 @@ void ofPolygonTriangulation::execute(ofDoublyConnectedEdgeList & dcel) {
 			triangulateQuad(dcel, face);
 			break;
 		default:
-			m_FacesPendingTriangulation.push(face);
+			facesPendingTriangulation.push_back(face);
 		}
 
 	} while (facesIterator.moveNext());
 
-	while (!m_FacesPendingTriangulation.empty()) {
-		auto face = m_FacesPendingTriangulation.top();
-		m_FacesPendingTriangulation.pop();
+	if (isConcurrent && facesPendingTriangulation.size() > 1) {
+		triangulatePendingFacesConcurrently(dcel, workspace, *workers);
+	}
+
+	while (!facesPendingTriangulation.empty()) {
+		auto face = facesPendingTriangulation.back();
+		facesPendingTriangulation.pop_back();
 
-		// We must ensure that all the vertices we are about to process have an incident edge on the current face.
-		auto halfEdgeIterator = ofDoublyConnectedEdgeList::HalfEdgesIterator(face);
-		do {
-			auto edge = halfEdgeIterator.getCurrent();
-			edge.getOrigin().setIncidentEdge(edge);
-		} while (halfEdgeIterator.moveNext());
+		triangulateMonotone.execute(dcel, face);
+	}
+
+	return path;
+}
+
+ofPolygonTriangulation::Path ofPolygonTriangulation::triangulate(const ofPolygonVerticesView & vertices, unsigned int * indices, unsigned int baseVertex,
+	Workspace & workspace, const Options & options, MonotoneWorkers * workers) {
+	const auto numVertices = vertices.getNumVertices();
+
+	// Ear clipping bails out on degenerate polygons, which are then left to the doubly connected edge list.
+	auto & earClipping = workspace.m_EarClipping;
+	earClipping.setRobustPredicates(options.robustPredicates);
+	if (numVertices < options.smallPolygonThreshold
+		&& earClipping.tryExecute(vertices.getPositions(), numVertices, vertices.getStride(), indices, baseVertex)) {
+		return Path::EarClipping;
+	}
+
+	auto & dcel = workspace.m_Dcel;
+	dcel.setStats(options.stats);
+	dcel.initializeFromCCWVertices(vertices.getPositions(), numVertices, vertices.getStride());
+	const auto path = triangulate(dcel, workspace, options, workers);
+
+	if (dcel.getNumTriangles() + 2 != numVertices) {
+		throw std::runtime_error("Triangulation failed.");
+	}
 
-		m_TriangulateMonotone.execute(dcel, face);
+	if (options.optimizeVertexCache) {
+		workspace.m_OptimizeVertexCache.execute(dcel);
 	}
+
+	dcel.extractTriangles(indices, baseVertex);
+	return path;
+}
+
+ofPolygonTriangulation::Path ofPolygonTriangulation::triangulate(ofDoublyConnectedEdgeList & dcel, Workspace & workspace, const Options & options) {
+	return triangulate(dcel, workspace, options, nullptr);
+}
+
+ofPolygonTriangulation::Path ofPolygonTriangulation::triangulate(
+	const ofPolygonVerticesView & vertices, unsigned int * indices, unsigned int baseVertex, Workspace & workspace, const Options & options) {
+	return triangulate(vertices, indices, baseVertex, workspace, options, nullptr);
+}
+
+void ofPolygonTriangulation::execute(ofDoublyConnectedEdgeList & dcel) {
+	m_Path = triangulate(dcel, m_Workspace, m_Options, &m_MonotoneWorkers);
+}
+
+template <class vecN>
+void ofPolygonTriangulation::execute(const std::vector<vecN> & vertices, unsigned int * indices, unsigned int baseVertex) {
+	m_Path = triangulate(ofPolygonVerticesView(vertices), indices, baseVertex, m_Workspace, m_Options, &m_MonotoneWorkers);
+}
+
+void ofPolygonTriangulation::execute(const std::vector<glm::vec2> & vertices, unsigned int * indices, unsigned int baseVertex) {
+	execute<glm::vec2>(vertices, indices, baseVertex);
+}
+
+void ofPolygonTriangulation::execute(const std::vector<glm::vec3> & vertices, unsigned int * indices, unsigned int baseVertex) {
+	execute<glm::vec3>(vertices, indices, baseVertex);
+}
+
+void ofPolygonTriangulation::execute(const std::vector<glm::vec2> & vertices, std::vector<unsigned int> & indices) {
+	indices.resize(vertices.size() > 2 ? (vertices.size() - 2) * 3 : 0);
+	execute<glm::vec2>(vertices, indices.data(), 0);
+}
+
+void ofPolygonTriangulation::execute(const std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices) {
+	indices.resize(vertices.size() > 2 ? (vertices.size() - 2) * 3 : 0);
+	execute<glm::vec3>(vertices, indices.data(), 0);
 }
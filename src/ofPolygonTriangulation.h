@@ -1,21 +1,350 @@
 #pragma once
 
+#include "ofEarClipping.h"
+#include "ofOptimizeVertexCache.h"
+#include "ofPolygonTriangulationStats.h"
 #include "ofSplitToMonotone.h"
 #include "ofTriangulateMonotone.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief A read only view of the vertices of a polygon, as interleaved single precision points.
+///
+/// The view does not own the vertices, which must outlive it. Only the x and y coordinates are read.
+class ofPolygonVerticesView {
+public:
+	/// @brief Creates a view of a buffer of points.
+	/// @param positions A pointer to the x coordinate of the first point, followed by its y coordinate.
+	/// @param numVertices The number of points.
+	/// @param stride The distance in bytes between two consecutive points.
+	ofPolygonVerticesView(const float * positions, std::size_t numVertices, std::size_t stride)
+		: m_Positions(positions)
+		, m_NumVertices(numVertices)
+		, m_Stride(stride) { }
+
+	/// @brief Creates a view of a vector of points.
+	/// @param vertices The points.
+	ofPolygonVerticesView(const std::vector<glm::vec2> & vertices)
+		: ofPolygonVerticesView(reinterpret_cast<const float *>(vertices.data()), vertices.size(), sizeof(glm::vec2)) { }
+
+	/// @brief Creates a view of a vector of points, the 3rd dimension being ignored.
+	/// @param vertices The points.
+	ofPolygonVerticesView(const std::vector<glm::vec3> & vertices)
+		: ofPolygonVerticesView(reinterpret_cast<const float *>(vertices.data()), vertices.size(), sizeof(glm::vec3)) { }
+
+	/// @brief Returns a pointer to the x coordinate of the first point.
+	inline const float * getPositions() const { return m_Positions; }
+
+	/// @brief Returns the number of points.
+	inline std::size_t getNumVertices() const { return m_NumVertices; }
+
+	/// @brief Returns the distance in bytes between two consecutive points.
+	inline std::size_t getStride() const { return m_Stride; }
+
+private:
+	const float * m_Positions;
+	std::size_t m_NumVertices;
+	std::size_t m_Stride;
+};
+
+/// @brief Settings of a triangulation, see ofPolygonTriangulation::triangulate().
+struct ofPolygonTriangulationOptions {
+	/// @brief The number of vertices below which polygons are triangulated by ear clipping, see ofPolygonTriangulation::setSmallPolygonThreshold().
+	std::size_t smallPolygonThreshold { 16 };
+	/// @brief Whether geometric predicates are evaluated exactly, see ofPolygonTriangulation::setRobustPredicates().
+	bool robustPredicates { false };
+	/// @brief Whether triangles extracted from polygons passed as vertices are reordered for vertex reuse, see ofPolygonTriangulation::setOptimizeVertexCache().
+	bool optimizeVertexCache { false };
+	/// @brief The stats filled by the triangulation, see ofPolygonTriangulation::setStats(), null if none.
+	ofPolygonTriangulationStats * stats { nullptr };
+};
 
 /// @brief A class implementing polygon triangulation.
+///
+/// Instances keep their scratch memory and settings, and may not be used from several threads at once.
+/// The static triangulate() functions only touch the workspace and options they are passed,
+/// so that threads may triangulate concurrently, each with its own workspace.
 class ofPolygonTriangulation {
 public:
+	/// @brief The path taken to triangulate a polygon, from the fastest to the most general.
+	enum class Path {
+		/// @brief The polygon was triangulated by ear clipping, without a doubly connected edge list.
+		EarClipping,
+		/// @brief The polygon is convex and was triangulated as a fan.
+		Convex,
+		/// @brief The polygon is monotone, it was triangulated without being split.
+		Monotone,
+		/// @brief The polygon was split into monotone polygons, each of them being triangulated.
+		SplitToMonotone
+	};
+
+	/// @brief Settings of a triangulation.
+	using Options = ofPolygonTriangulationOptions;
+
+	/// @brief The scratch memory of triangulations.
+	///
+	/// Meant to be kept between triangulations, for instance pooled per thread,
+	/// as triangulating polygons with as many vertices or less does not allocate then.
+	/// Workspaces can be moved but not copied, and must not be used by several threads at once.
+	class Workspace {
+	public:
+		Workspace() = default;
+
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+		/// @brief Creates a workspace allocating all its memory from a memory resource.
+		/// @param resource The memory resource, which must outlive the workspace.
+		explicit Workspace(ofPolygonMemoryResource * resource);
+#endif
+
+		Workspace(Workspace &&) = default;
+		Workspace & operator=(Workspace &&) = default;
+		Workspace(const Workspace &) = delete;
+		Workspace & operator=(const Workspace &) = delete;
+
+		/// @brief Reserves memory for triangulating polygons with up to a given number of vertices.
+		/// @param numVertices The number of vertices.
+		void reserve(std::size_t numVertices);
+
+	private:
+		friend class ofPolygonTriangulation;
+
+		ofSplitToMonotone m_SplitToMonotone;
+		ofTriangulateMonotone m_TriangulateMonotone;
+		ofPolygonVector<ofDoublyConnectedEdgeList::Face> m_FacesPendingTriangulation;
+		// Classification of the vertices of the initial polygon, used to pick the triangulation path.
+		ofPolygonVector<ofSplitToMonotone::VertexType> m_VerticesClassification;
+		// The first pair of half edges allocated for the diagonals of each pending face, with several threads.
+		ofPolygonVector<index_t> m_FacesFirstEdgePair;
+
+		// Polygons passed as vertices.
+		ofEarClipping m_EarClipping;
+		ofDoublyConnectedEdgeList m_Dcel;
+		ofOptimizeVertexCache m_OptimizeVertexCache;
+	};
+
+	/// @brief Triangulates a doubly connected edge list, using the memory of a workspace.
+	/// @param dcel The doubly connected edge list.
+	/// @param workspace The workspace.
+	/// @param options The settings of the triangulation.
+	/// @return The path taken to triangulate the polygon.
+	///
+	/// As execute(), on the calling thread only.
+	static Path triangulate(ofDoublyConnectedEdgeList & dcel, Workspace & workspace, const Options & options = Options());
+
+	/// @brief Triangulates a polygon, using the memory of a workspace.
+	/// @param vertices The polygon points in counter clockwise order.
+	/// @param indices The buffer, holding at least 3 (n - 2) indices for n vertices.
+	/// @param baseVertex The offset added to each index.
+	/// @param workspace The workspace.
+	/// @param options The settings of the triangulation.
+	/// @return The path taken to triangulate the polygon.
+	///
+	/// As execute(), on the calling thread only. Vertices are only read.
+	static Path triangulate(const ofPolygonVerticesView & vertices, unsigned int * indices, unsigned int baseVertex,
+		Workspace & workspace, const Options & options = Options());
+
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	ofPolygonTriangulation() = default;
+
+	/// @brief Creates an instance allocating all its memory from a memory resource.
+	/// @param resource The memory resource, which must outlive the instance.
+	///
+	/// This includes scratch memory, the threads triangulating monotone polygons, and the doubly connected edge list
+	/// used for polygons passed as vertices. With several threads, the resource is used concurrently
+	/// unless memory was reserved beforehand, see reserve().
+	explicit ofPolygonTriangulation(ofPolygonMemoryResource * resource);
+#endif
+
 	/// @brief Triangulates a doubly connected edge list.
 	/// @param dcel The doubly connected edge list.
 	///
 	/// Triangulation will occur in two steps.
 	/// First the doubly connected edge list is split into monotone polygons.
 	/// Then the monotone polygons are triangulated.
+	/// A first pass over the vertices detects convex and monotone polygons, for which these steps are partly skipped.
 	void execute(ofDoublyConnectedEdgeList & dcel);
 
+	/// @brief Triangulates a polygon.
+	/// @param vertices The polygon points in counter clockwise order.
+	/// @param indices The geometry indices, 3 per triangle.
+	///
+	/// Polygons with fewer vertices than the small polygon threshold are triangulated directly by ear clipping,
+	/// others through a doubly connected edge list owned by this instance.
+	/// Either way, triangles are in counter clockwise order and indices refer to the passed vertices.
+	void execute(const std::vector<glm::vec2> & vertices, std::vector<unsigned int> & indices);
+
+	/// @brief Triangulates a polygon.
+	/// @param vertices The polygon points in counter clockwise order.
+	/// @param indices The geometry indices, 3 per triangle.
+	///
+	/// The 3rd dimensions is ignored and accepted as a parameter for compatibility reasons.
+	void execute(const std::vector<glm::vec3> & vertices, std::vector<unsigned int> & indices);
+
+	/// @brief Triangulates a polygon, writing indices to a caller provided buffer.
+	/// @param vertices The polygon points in counter clockwise order.
+	/// @param indices The buffer, holding at least 3 (n - 2) indices for n vertices.
+	/// @param baseVertex The offset added to each index.
+	void execute(const std::vector<glm::vec2> & vertices, unsigned int * indices, unsigned int baseVertex = 0);
+
+	/// @brief Triangulates a polygon, writing indices to a caller provided buffer.
+	/// @param vertices The polygon points in counter clockwise order.
+	/// @param indices The buffer, holding at least 3 (n - 2) indices for n vertices.
+	/// @param baseVertex The offset added to each index.
+	///
+	/// The 3rd dimensions is ignored and accepted as a parameter for compatibility reasons.
+	void execute(const std::vector<glm::vec3> & vertices, unsigned int * indices, unsigned int baseVertex = 0);
+
+	/// @brief Returns the path taken by the last triangulation.
+	inline Path getPath() const { return m_Path; }
+
+	/// @brief Sets the number of vertices below which polygons are triangulated by ear clipping.
+	/// @param numVertices The number of vertices, 16 by default, 0 to always use a doubly connected edge list.
+	inline void setSmallPolygonThreshold(std::size_t numVertices) { m_Options.smallPolygonThreshold = numVertices; }
+
+	/// @brief Returns the number of vertices below which polygons are triangulated by ear clipping.
+	inline std::size_t getSmallPolygonThreshold() const { return m_Options.smallPolygonThreshold; }
+
+	/// @brief Reserves memory for triangulating polygons with up to a given number of vertices.
+	/// @param numVertices The number of vertices.
+	///
+	/// Once a polygon has been triangulated, triangulating polygons with as many vertices or less does not allocate memory.
+	/// This includes the doubly connected edge list, provided it is reused as well.
+	void reserve(std::size_t numVertices);
+
+	/// @brief Sets the number of threads triangulating monotone polygons.
+	/// @param numThreads The number of threads, 0 to use the number of hardware threads.
+	///
+	/// Once the polygon is split, monotone polygons are independent and may be triangulated concurrently.
+	/// This pays off for large polygons only, see setConcurrentThreshold(). The triangulation does not depend on the number of threads.
+	/// Threads are started here and wait between triangulations, so that triangulating does not allocate nor start threads.
+	/// A single thread is used by default.
+	void setNumThreads(std::size_t numThreads);
+
+	/// @brief Returns the number of threads triangulating monotone polygons.
+	inline std::size_t getNumThreads() const { return m_MonotoneWorkers.getNumThreads() + 1; }
+
+	/// @brief Sets the number of vertices below which monotone polygons are triangulated on the calling thread only.
+	/// @param numVertices The number of vertices of the polygon, 8192 by default.
+	///
+	/// Waking threads up costs more than triangulating small polygons.
+	inline void setConcurrentThreshold(std::size_t numVertices) { m_MonotoneWorkers.setThreshold(numVertices); }
+
+	/// @brief Returns the number of vertices below which monotone polygons are triangulated on the calling thread only.
+	inline std::size_t getConcurrentThreshold() const { return m_MonotoneWorkers.getThreshold(); }
+
+	/// @brief Sets whether geometric predicates are evaluated exactly.
+	/// @param robustPredicates True to use exact predicates, false by default.
+	///
+	/// Rounding makes orientation tests unreliable for large coordinates, around 1e5 and beyond,
+	/// which may fail the triangulation. Exact predicates only cost extra work on nearly degenerate configurations.
+	void setRobustPredicates(bool robustPredicates);
+
+	/// @brief Returns whether geometric predicates are evaluated exactly.
+	inline bool getRobustPredicates() const { return m_Options.robustPredicates; }
+
+	/// @brief Sets whether triangles are reordered for vertex reuse, when polygons are passed as vertices.
+	/// @param optimizeVertexCache True to reorder triangles, false by default.
+	///
+	/// Worth it for polygons drawn many times, see ofOptimizeVertexCache. Ear clipped polygons are left as is.
+	inline void setOptimizeVertexCache(bool optimizeVertexCache) { m_Options.optimizeVertexCache = optimizeVertexCache; }
+
+	/// @brief Returns whether triangles are reordered for vertex reuse, when polygons are passed as vertices.
+	inline bool getOptimizeVertexCache() const { return m_Options.optimizeVertexCache; }
+
+	/// @brief Sets the stats filled by triangulations.
+	/// @param stats The stats, which must outlive their use, or null to stop filling them.
+	///
+	/// Doubly connected edge lists passed to execute() fill them for the duration of the triangulation,
+	/// unless stats of their own are attached.
+	/// Only filled when OF_POLYGON_TRIANGULATION_STATS is defined, see ofPolygonTriangulationStats.h.
+	inline void setStats(ofPolygonTriangulationStats * stats) { m_Options.stats = stats; }
+
+	/// @brief Returns the stats filled by triangulations, null if none.
+	inline ofPolygonTriangulationStats * getStats() const { return m_Options.stats; }
+
+	/// @brief Returns the settings of triangulations, as passed to triangulate().
+	inline const Options & getOptions() const { return m_Options; }
+
 private:
-	ofSplitToMonotone m_SplitToMonotone;
-	ofTriangulateMonotone m_TriangulateMonotone;
-	std::stack<ofDoublyConnectedEdgeList::Face> m_FacesPendingTriangulation;
+	// Threads triangulating monotone polygons along with the calling thread.
+	// Started once, they wait for faces between triangulations.
+	class MonotoneWorkers {
+	public:
+		MonotoneWorkers() = default;
+
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+		explicit MonotoneWorkers(ofPolygonMemoryResource * resource);
+#endif
+
+		// Stops and joins the threads.
+		~MonotoneWorkers();
+
+		MonotoneWorkers(const MonotoneWorkers &) = delete;
+		MonotoneWorkers & operator=(const MonotoneWorkers &) = delete;
+
+		// The number of threads besides the calling one.
+		inline std::size_t getNumThreads() const { return m_Threads.size(); }
+		void setNumThreads(std::size_t numThreads);
+
+		inline std::size_t getThreshold() const { return m_Threshold; }
+		inline void setThreshold(std::size_t numVertices) { m_Threshold = numVertices; }
+
+		void reserve(std::size_t numVertices);
+		void setRobustPredicates(bool robustPredicates);
+
+		// Triangulates faces, each one with diagonals allocated from its own first pair of half edges,
+		// the calling thread using its own instance. The first error is thrown once all threads are done.
+		void execute(ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face * faces, const index_t * facesFirstEdgePair,
+			std::size_t numFaces, index_t firstEdgePair, ofTriangulateMonotone & triangulateMonotone);
+
+	private:
+		// One per thread.
+		ofPolygonVector<ofTriangulateMonotone> m_TriangulateMonotone;
+		ofPolygonVector<std::thread> m_Threads;
+		// One per thread, the last one for the calling thread.
+		ofPolygonVector<std::exception_ptr> m_Errors;
+		std::size_t m_Threshold { 8192 };
+
+		// The current run, written by the calling thread before threads are woken up.
+		ofDoublyConnectedEdgeList * m_Dcel { nullptr };
+		const ofDoublyConnectedEdgeList::Face * m_Faces { nullptr };
+		const index_t * m_FacesFirstEdgePair { nullptr };
+		std::size_t m_NumFaces { 0 };
+		index_t m_FirstEdgePair { 0 };
+		// The next face to be claimed by a thread.
+		std::atomic<std::size_t> m_NextFace { 0 };
+
+		// Guards the run counters below, threads wait for a new run, the calling thread for all of them to be done.
+		std::mutex m_Mutex;
+		std::condition_variable m_RunStarted;
+		std::condition_variable m_RunDone;
+		std::size_t m_NumRuns { 0 };
+		std::size_t m_NumBusyThreads { 0 };
+		bool m_IsStopping { false };
+
+		void stopThreads();
+		void runThread(std::size_t threadIndex);
+		void triangulate(ofTriangulateMonotone & triangulateMonotone, std::exception_ptr & error);
+	};
+
+	Workspace m_Workspace;
+	Options m_Options;
+	Path m_Path { Path::SplitToMonotone };
+	MonotoneWorkers m_MonotoneWorkers;
+
+	// Monotone polygons are triangulated concurrently when workers are passed.
+	static Path triangulate(ofDoublyConnectedEdgeList & dcel, Workspace & workspace, const Options & options,
+		MonotoneWorkers * workers);
+	static Path triangulate(const ofPolygonVerticesView & vertices, unsigned int * indices, unsigned int baseVertex,
+		Workspace & workspace, const Options & options, MonotoneWorkers * workers);
+	static void triangulatePendingFacesConcurrently(
+		ofDoublyConnectedEdgeList & dcel, Workspace & workspace, MonotoneWorkers & workers);
+
+	// Private template, DRY but safe API.
+	template <class vecN>
+	void execute(const std::vector<vecN> & vertices, unsigned int * indices, unsigned int baseVertex);
 };
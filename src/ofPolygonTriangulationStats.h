@@ -0,0 +1,90 @@
+/// \file ofPolygonTriangulationStats.h
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+/// @brief Timings and counters of triangulations, per phase.
+///
+/// Attached to the doubly connected edge list and the triangulation classes with their setStats() method,
+/// and accumulated over successive runs until reset.
+/// Only filled when OF_POLYGON_TRIANGULATION_STATS is defined, project wide, instrumentation compiles to nothing otherwise.
+/// Monotone polygons triangulated by other threads are accounted for as a whole, by the calling thread.
+struct ofPolygonTriangulationStats {
+	using duration_t = std::chrono::steady_clock::duration;
+
+	/// @brief Time spent checking the winding order of polygons, when initializing edge lists.
+	duration_t windingCheck {};
+	/// @brief Time spent classifying vertices, and collecting them for the sweep line.
+	duration_t classification {};
+	/// @brief Time spent sorting vertices along the sweep line.
+	duration_t sort {};
+	/// @brief Time spent sweeping polygons, splitting them into monotone polygons.
+	duration_t sweep {};
+	/// @brief Time spent triangulating monotone polygons, convex polygons included.
+	duration_t monotoneTriangulation {};
+	/// @brief Time spent extracting triangles from edge lists.
+	duration_t extraction {};
+
+	/// @brief The number of diagonals inserted, splitting faces.
+	std::size_t numDiagonals { 0 };
+	/// @brief The number of split vertices met by the sweep line.
+	std::size_t numSplitVertices { 0 };
+	/// @brief The number of merge vertices met by the sweep line.
+	std::size_t numMergeVertices { 0 };
+	/// @brief The number of monotone polygons triangulated, triangles and quads included.
+	std::size_t numMonotonePolygons { 0 };
+	/// @brief The number of pairs of faces compared when looking for the face shared by two vertices.
+	std::size_t numSharedFaceIterations { 0 };
+	/// @brief The number of half edges whose face was assigned again after a split.
+	std::size_t numFaceRelabels { 0 };
+
+	/// @brief Resets all timings and counters.
+	void reset() { *this = ofPolygonTriangulationStats(); }
+};
+
+#ifdef OF_POLYGON_TRIANGULATION_STATS
+
+// Adds the duration of its scope to a timing, if stats are attached.
+class ofPolygonStatsTimer {
+public:
+	ofPolygonStatsTimer(ofPolygonTriangulationStats * stats, ofPolygonTriangulationStats::duration_t ofPolygonTriangulationStats::*timing)
+		: m_Stats(stats)
+		, m_Timing(timing) {
+		if (m_Stats != nullptr) {
+			m_Start = std::chrono::steady_clock::now();
+		}
+	}
+
+	~ofPolygonStatsTimer() {
+		if (m_Stats != nullptr) {
+			m_Stats->*m_Timing += std::chrono::steady_clock::now() - m_Start;
+		}
+	}
+
+	ofPolygonStatsTimer(const ofPolygonStatsTimer &) = delete;
+	ofPolygonStatsTimer & operator=(const ofPolygonStatsTimer &) = delete;
+
+private:
+	ofPolygonTriangulationStats * m_Stats;
+	ofPolygonTriangulationStats::duration_t ofPolygonTriangulationStats::*m_Timing;
+	std::chrono::steady_clock::time_point m_Start;
+};
+
+#define OF_POLYGON_STATS_SCOPE(stats, timing) ofPolygonStatsTimer statsTimer_##timing((stats), &ofPolygonTriangulationStats::timing)
+#define OF_POLYGON_STATS_ADD(stats, counter, value) \
+	do { \
+		if ((stats) != nullptr) { \
+			(stats)->counter += (value); \
+		} \
+	} while (false)
+
+#else
+
+#define OF_POLYGON_STATS_SCOPE(stats, timing)
+#define OF_POLYGON_STATS_ADD(stats, counter, value) \
+	do { \
+	} while (false)
+
+#endif
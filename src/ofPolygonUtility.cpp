@@ -1,4 +1,5 @@
 #include "ofPolygonUtility.h"
+#include "ofDoublyConnectedEdgeList.h"
 #include "ofMain.h"
 #include <glm/gtx/vector_angle.hpp>
 
@@ -9,7 +10,7 @@ void ofPolygonUtility::createPolygonRandom(std::vector<glm::vec3> & points) {
 	auto noiseX = 0.f;
 	auto dAngle = glm::pi<float>() * 2.0f / (float)numPoints;
 
-	for (auto i = 0; i != numPoints; ++i) {
+	for (std::size_t i = 0; i != numPoints; ++i) {
 		auto angle = glm::mix(dAngle * i, dAngle * (i + 1), ofNoise(noiseX, angleNoiseY));
 		auto radius = glm::mix(0.2f, 1.0f, ofNoise(noiseX, radiusNoiseY));
 		points[i] = glm::vec3(radius * glm::cos(angle), radius * glm::sin(angle), 0);
@@ -32,7 +33,7 @@ void ofPolygonUtility::createPolygonRandomMonotone(std::vector<glm::vec3> & poin
 	points[0] = glm::vec3(0, 1, 0);
 
 	// Left chain.
-	for (auto i = 1; i != midPoint; ++i) {
+	for (std::size_t i = 1; i != midPoint; ++i) {
 		auto x = glm::mix(-1.0f, -0.1f, ofNoise(noiseX, xNoiseY));
 		auto y = glm::mix(yAcc + epsilon, yAcc + dY - epsilon, ofNoise(noiseX, yNoiseY));
 		points[i] = glm::vec3(x, y, 0);
@@ -55,12 +56,78 @@ void ofPolygonUtility::createPolygonRandomMonotone(std::vector<glm::vec3> & poin
 	}
 }
 
+void ofPolygonUtility::createPolygonSpiral(std::vector<glm::vec3> & points) {
+	constexpr auto innerRadius = 0.1f;
+	const auto numPoints = points.size();
+	const auto numOuterPoints = numPoints / 2;
+	const auto numInnerPoints = numPoints - numOuterPoints;
+
+	// Keep enough points per turn so that chords do not cross the neighboring arm.
+	const auto numTurns = glm::clamp((float)numOuterPoints / 32.0f, 0.5f, 8.0f);
+	const auto maxAngle = numTurns * glm::pi<float>() * 2.0f;
+	const auto radiusPerRadian = 0.8f / maxAngle;
+	const auto thickness = 0.4f * radiusPerRadian * glm::pi<float>() * 2.0f;
+
+	// Outer side, moving outwards in counter clockwise order.
+	for (std::size_t i = 0; i != numOuterPoints; ++i) {
+		auto angle = maxAngle * (float)i / (float)(numOuterPoints - 1);
+		auto radius = innerRadius + thickness + radiusPerRadian * angle;
+		points[i] = glm::vec3(radius * glm::cos(angle), radius * glm::sin(angle), 0);
+	}
+
+	// Inner side, moving back inwards.
+	for (std::size_t i = 0; i != numInnerPoints; ++i) {
+		auto angle = maxAngle * (1.0f - (float)i / (float)(numInnerPoints - 1));
+		auto radius = innerRadius + radiusPerRadian * angle;
+		points[numOuterPoints + i] = glm::vec3(radius * glm::cos(angle), radius * glm::sin(angle), 0);
+	}
+}
+
+void ofPolygonUtility::createPolygonComb(std::vector<glm::vec3> & points) {
+	constexpr auto yNoiseY = 0.6f;
+	constexpr auto noiseDx = 0.4f;
+	constexpr auto jitter = 0.1f;
+	const auto numPoints = points.size();
+
+	// Left corners, teeth (a tip and a notch each), right corner, and at least one point on the top arch.
+	const auto numTeeth = (numPoints - 4) / 2;
+	const auto numArchPoints = numPoints - 3 - numTeeth * 2;
+	const auto toothWidth = 2.0f / (float)numTeeth;
+
+	auto noiseX = 0.f;
+	auto index = std::size_t { 0 };
+
+	points[index++] = glm::vec3(-1, 0.95f, 0);
+	points[index++] = glm::vec3(-1, 0, 0);
+
+	for (std::size_t i = 0; i != numTeeth; ++i) {
+		auto x = -1.0f + toothWidth * i;
+		auto tipY = -1.0f + jitter * ofNoise(noiseX, yNoiseY);
+		noiseX += noiseDx;
+		auto notchY = jitter * ofNoise(noiseX, yNoiseY);
+		noiseX += noiseDx;
+		points[index++] = glm::vec3(x + toothWidth * 0.5f, tipY, 0);
+		// The last notch is the bottom right corner.
+		points[index++] = glm::vec3(i == numTeeth - 1 ? 1.0f : x + toothWidth, notchY, 0);
+	}
+
+	points[index++] = glm::vec3(1, 1, 0);
+
+	// Top arch, from right to left, no two consecutive points share the same height.
+	for (std::size_t i = 0; i != numArchPoints; ++i) {
+		auto t = (float)(i + 1) / (float)(numArchPoints + 1);
+		auto y = glm::mix(1.0f, 0.95f, t) + 0.1f * glm::sin(t * glm::pi<float>());
+		points[index++] = glm::vec3(glm::mix(1.0f, -1.0f, t), y, 0);
+	}
+}
+
 template <typename vecN>
 void ofPolygonUtility::removeDuplicatesAndCollinear(std::vector<vecN> & points, float epsilon) {
 	while (points.size() > 3) {
-		auto rmIndex = -1;
 		auto count = points.size();
-		for (auto i = 0; i != count; ++i) {
+		// No point to remove as long as it is count.
+		auto rmIndex = count;
+		for (std::size_t i = 0; i != count; ++i) {
 			auto point = points[i];
 			auto nextPoint = points[(i + 1) % count];
 
@@ -81,7 +148,7 @@ void ofPolygonUtility::removeDuplicatesAndCollinear(std::vector<vecN> & points,
 		}
 
 		// Nothing left to do, exit.
-		if (rmIndex == -1) {
+		if (rmIndex == count) {
 			break;
 		}
 
@@ -89,6 +156,23 @@ void ofPolygonUtility::removeDuplicatesAndCollinear(std::vector<vecN> & points,
 	}
 }
 
+template <typename vecN>
+void ofPolygonUtility::scaleToScalarRange(std::vector<vecN> & points) {
+	if (std::is_integral<scalar_t>::value) {
+		for (auto & point : points) {
+			point = glm::round(point * static_cast<float>(1 << 20));
+		}
+	}
+}
+
+void ofPolygonUtility::scaleToScalarRange(std::vector<glm::vec2> & points) {
+	scaleToScalarRange<glm::vec2>(points);
+}
+
+void ofPolygonUtility::scaleToScalarRange(std::vector<glm::vec3> & points) {
+	scaleToScalarRange<glm::vec3>(points);
+}
+
 void ofPolygonUtility::removeDuplicatesAndCollinear(std::vector<glm::vec2> & points, float epsilon) {
 	removeDuplicatesAndCollinear<glm::vec2>(points, epsilon);
 }
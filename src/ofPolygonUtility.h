@@ -21,6 +21,21 @@ public:
 	/// Despite the use of random numbers the function is deterministic.
 	static void createPolygonRandomMonotone(std::vector<glm::vec3> & points);
 
+	/// @brief Generate a spiral polygon.
+	/// @param points The vector to write generated points into.
+	///
+	/// The polygon is a thick spiral arm, its number of turns grows with the number of points.
+	/// It yields many split and merge vertices and long monotone pieces.
+	static void createPolygonSpiral(std::vector<glm::vec3> & points);
+
+	/// @brief Generate a comb polygon.
+	/// @param points The vector to write generated points into.
+	///
+	/// Teeth point downwards, each notch between two teeth is a split vertex.
+	/// At least 6 points are expected.
+	/// Despite the use of random numbers the function is deterministic.
+	static void createPolygonComb(std::vector<glm::vec3> & points);
+
 	/// @brief Removes duplicate and collinear points from a polygon.
 	/// @param points The polygon.
 	/// @param epsilon The angular tolerance to establish collinearity.
@@ -33,7 +48,24 @@ public:
 	/// Note that the z component is ignored.
 	static void removeDuplicatesAndCollinear(std::vector<glm::vec3> & points, float epsilon);
 
+	/// @brief Scales generated points to the range of the coordinates of the edge list.
+	/// @param points The polygon, spanning the unit square.
+	///
+	/// With fixed point coordinates, points are scaled up by 2^20 and rounded,
+	/// so that the polygon keeps its shape and points match the positions of the edge list.
+	/// Floating point coordinates are left untouched.
+	static void scaleToScalarRange(std::vector<glm::vec2> & points);
+
+	/// @brief Scales generated points to the range of the coordinates of the edge list.
+	/// @param points The polygon, spanning the unit square.
+	///
+	/// Note that the z component is scaled as well.
+	static void scaleToScalarRange(std::vector<glm::vec3> & points);
+
 private:
+	template <typename vecN>
+	static void scaleToScalarRange(std::vector<vecN> & points);
+
 	template <typename vecN>
 	static void removeDuplicatesAndCollinear(std::vector<vecN> & points, float epsilon);
 };
\ No newline at end of file
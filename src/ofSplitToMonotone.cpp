@@ -1,40 +1,343 @@
 #include "ofSplitToMonotone.h"
+#include "ofPolygonKernels.h"
+#include "ofPolygonPredicates.h"
 #include "ofVertexSweepComparer.h"
-#include <glm/gtx/vector_angle.hpp>
+#include <array>
 #include <stdexcept>
 
-ofSplitToMonotone::VertexType ofSplitToMonotone::classifyVertex(const ofDoublyConnectedEdgeList::Vertex & vertex) {
-	const auto angle = glm::orientedAngle(
-		glm::normalize(vertex.getIncidentEdge().getPrev().getDirection()),
-		glm::normalize(vertex.getIncidentEdge().getDirection()));
+// Below this number of vertices, comparison sort outruns the fixed cost of radix sort passes.
+constexpr std::size_t k_MinRadixSortSize = 256;
 
-	auto comparer = ofVertexSweepComparer();
+// Least significant digit first radix sort, by x then by y, a byte at a time.
+// Being stable, the second half of the passes keeps vertices of equal y ordered by x.
+void sortSweepKeys(ofPolygonVector<ofVertexSweepKey> & keys, ofPolygonVector<ofVertexSweepKey> & scratch) {
+	if (keys.size() < k_MinRadixSortSize) {
+		std::sort(keys.begin(), keys.end());
+		return;
+	}
+
+	constexpr auto k_KeyBytes = sizeof(ofVertexSweepKey::bits_t);
+	scratch.resize(keys.size());
+	std::array<std::size_t, 256> offsets;
+
+	for (std::size_t pass = 0; pass != 2 * k_KeyBytes; ++pass) {
+		const auto field = pass < k_KeyBytes ? &ofVertexSweepKey::x : &ofVertexSweepKey::y;
+		const auto shift = (pass % k_KeyBytes) * 8;
+		auto getDigit = [field, shift](const ofVertexSweepKey & key) { return static_cast<std::size_t>((key.*field >> shift) & 0xFF); };
+
+		offsets.fill(0);
+		for (const auto & key : keys) {
+			++offsets[getDigit(key)];
+		}
+
+		// High bytes are often shared by all coordinates, there is nothing to sort then.
+		if (offsets[getDigit(keys.front())] == keys.size()) {
+			continue;
+		}
+
+		auto offset = std::size_t { 0 };
+		for (auto & count : offsets) {
+			const auto numKeys = count;
+			count = offset;
+			offset += numKeys;
+		}
+
+		for (const auto & key : keys) {
+			scratch[offsets[getDigit(key)]++] = key;
+		}
+
+		keys.swap(scratch);
+	}
+}
+
+ofSplitToMonotone::VertexType ofSplitToMonotone::classifyVertex(const ofDoublyConnectedEdgeList::Vertex & vertex, bool robustPredicates) {
 	auto prevVertex = vertex.getIncidentEdge().getPrev().getOrigin();
 	auto nextVertex = vertex.getIncidentEdge().getDestination();
-	auto compPrev = comparer(prevVertex, vertex);
-	auto compNext = comparer(vertex, nextVertex);
+
+	// The sign of the turn at the vertex, positive if the interior angle is less than pi.
+	const auto turn = robustPredicates
+		? ofOrient2dAdaptive(prevVertex.getPosition(), vertex.getPosition(), nextVertex.getPosition())
+		: ofCross2d(vertex.getIncidentEdge().getPrev().getDirection(), vertex.getIncidentEdge().getDirection());
+
+	return classifyTurn(prevVertex.getPosition(), vertex.getPosition(), nextVertex.getPosition(), turn > 0);
+}
+
+ofSplitToMonotone::VertexType ofSplitToMonotone::classifyTurn(const position_t & prev, const position_t & vertex, const position_t & next, bool isConvex) {
+	// Whether the first position comes before the last one along the sweep, as ofVertexSweepComparer.
+	auto precedes = [](const position_t & first, const position_t & last) {
+		return first.y == last.y ? first.x < last.x : last.y < first.y;
+	};
+
+	auto compPrev = precedes(prev, vertex);
+	auto compNext = precedes(vertex, next);
 
 	// If the 2 neighbors lie above.
 	if (compPrev && !compNext) {
-		return angle > 0 ? ofSplitToMonotone::VertexType::Stop : ofSplitToMonotone::VertexType::Merge;
+		return isConvex ? ofSplitToMonotone::VertexType::Stop : ofSplitToMonotone::VertexType::Merge;
 	}
 
 	// If the 2 neighbors lie below.
 	if (!compPrev && compNext) {
-		return angle > 0 ? ofSplitToMonotone::VertexType::Start : ofSplitToMonotone::VertexType::Split;
+		return isConvex ? ofSplitToMonotone::VertexType::Start : ofSplitToMonotone::VertexType::Split;
 	}
 
 	return ofSplitToMonotone::VertexType::Regular;
 }
 
+void ofSplitToMonotone::SweepLineStatus::clear() {
+	// Edges are unmapped as they are removed, only those left after a failure remain.
+	for (const auto & node : m_Nodes) {
+		m_EdgeNodes[node.edge.getIndex()] = k_NullNode;
+	}
+
+	m_Nodes.clear();
+	m_FreeNodes.clear();
+	m_Root = k_NullNode;
+	// Restart the priorities sequence so that the tree layout is deterministic.
+	m_PrioritySeed = 0;
+}
+
+void ofSplitToMonotone::SweepLineStatus::reserve(std::size_t numVertices) {
+	// There cannot be more edges crossing the sweep line than vertices.
+	m_Nodes.reserve(numVertices);
+	m_FreeNodes.reserve(numVertices);
+	// A triangulated polygon has less than 4 half edges per vertex.
+	m_EdgeNodes.reserve(numVertices * 4);
+}
+
+ofDoublyConnectedEdgeList::HalfEdge ofSplitToMonotone::SweepLineStatus::getHelper(const ofDoublyConnectedEdgeList::HalfEdge & edge) {
+	const auto edgeIndex = edge.getIndex();
+
+	if (edgeIndex >= m_EdgeNodes.size() || m_EdgeNodes[edgeIndex] == k_NullNode) {
+		throw std::runtime_error("Could not find helper.");
+	}
+
+	return m_Nodes[m_EdgeNodes[edgeIndex]].helper;
+}
+
+ofDoublyConnectedEdgeList::HalfEdge & ofSplitToMonotone::SweepLineStatus::findLeftHelper(ofDoublyConnectedEdgeList::Vertex vertex) {
+	// Descend the tree looking for the rightmost edge strictly to the left of the vertex.
+	// Edges ending at the vertex intersect the sweep line at the vertex and are excluded.
+	auto leftNode = k_NullNode;
+	auto node = m_Root;
+	const auto position = vertex.getPosition();
+
+	while (node != k_NullNode) {
+		const auto & edge = m_Nodes[node].edge;
+		if (edge.getDestination() != vertex && compare(edge, position) < 0) {
+			leftNode = node;
+			node = m_Nodes[node].right;
+		} else {
+			node = m_Nodes[node].left;
+		}
+	}
+
+	if (leftNode == k_NullNode) {
+		throw std::runtime_error("Could not find left edge.");
+	}
+
+	return m_Nodes[leftNode].helper;
+}
+
+void ofSplitToMonotone::SweepLineStatus::emplace(ofDoublyConnectedEdgeList::HalfEdge edge, ofDoublyConnectedEdgeList::HalfEdge helper) {
+	auto node = k_NullNode;
+	if (m_FreeNodes.empty()) {
+		node = m_Nodes.size();
+		m_Nodes.push_back({});
+	} else {
+		node = m_FreeNodes.back();
+		m_FreeNodes.pop_back();
+	}
+
+	m_Nodes[node] = { edge, helper, nextPriority(), k_NullNode, k_NullNode };
+	m_Root = insert(m_Root, node, getSweepPoint(edge));
+
+	const auto edgeIndex = edge.getIndex();
+	if (edgeIndex >= m_EdgeNodes.size()) {
+		m_EdgeNodes.resize(edgeIndex + 1, k_NullNode);
+	}
+	m_EdgeNodes[edgeIndex] = node;
+}
+
+void ofSplitToMonotone::SweepLineStatus::remove(ofDoublyConnectedEdgeList::HalfEdge edge) {
+	auto found = false;
+	m_Root = erase(m_Root, edge, getSweepPoint(edge), found);
+
+	if (!found) {
+		throw std::runtime_error("Could not find edge to remove.");
+	}
+
+	m_EdgeNodes[edge.getIndex()] = k_NullNode;
+}
+
+ofPolygonReal_t<scalar_t> ofSplitToMonotone::SweepLineStatus::getSweepX(const ofDoublyConnectedEdgeList::HalfEdge & edge) const {
+	auto origin = edge.getOrigin().getPosition();
+	auto destination = edge.getDestination().getPosition();
+
+	// An horizontal edge only lives in the status while the sweep line is on it,
+	// we use its destination so that it is never seen as left of its destination.
+	if (origin.y == destination.y) {
+		return destination.x;
+	}
+
+	bool _;
+	return ofHalfEdgeSweepComparer::sweepIntersection(edge, m_Coordinate, _).x;
+}
+
+// The intersection of an edge meeting the sweep line at the current vertex, which is an endpoint of the edge,
+// so that it is exact.
+position_t ofSplitToMonotone::SweepLineStatus::getSweepPoint(const ofDoublyConnectedEdgeList::HalfEdge & edge) const {
+	auto origin = edge.getOrigin().getPosition();
+	auto destination = edge.getDestination().getPosition();
+
+	// As getSweepX(), horizontal edges are represented by their destination.
+	if (origin.y == m_Coordinate && origin.y != destination.y) {
+		return origin;
+	}
+
+	return destination;
+}
+
+// Returns the sign of the position of an edge relative to a point of the sweep line, negative if the edge lies left of it.
+int ofSplitToMonotone::SweepLineStatus::compare(const ofDoublyConnectedEdgeList::HalfEdge & edge, const position_t & sweepPoint) const {
+	// Integer coordinates are always compared exactly, intersections would be rounded.
+	if (!m_RobustPredicates && std::is_floating_point<scalar_t>::value) {
+		auto sweepX = getSweepX(edge);
+		return sweepX < sweepPoint.x ? -1 : (sweepX > sweepPoint.x ? 1 : 0);
+	}
+
+	auto origin = edge.getOrigin().getPosition();
+	auto destination = edge.getDestination().getPosition();
+
+	if (origin.y == destination.y) {
+		return destination.x < sweepPoint.x ? -1 : (destination.x > sweepPoint.x ? 1 : 0);
+	}
+
+	// The point lies right of an edge going down if the triangle they form is counter clockwise.
+	auto orientation = ofOrient2dAdaptive(origin, destination, sweepPoint);
+	if (orientation == 0.0) {
+		return 0;
+	}
+	return (orientation > 0.0) == (origin.y > destination.y) ? -1 : 1;
+}
+
+// Edges meeting at the sweep line share the same key, their order was decided before they met,
+// so we may have to look on both sides.
+// Orders edges by their intersection with the sweep line, ties are broken using indices.
+bool ofSplitToMonotone::SweepLineStatus::isLeftOf(const ofDoublyConnectedEdgeList::HalfEdge & edge, const position_t & sweepPoint, index_t node) const {
+	const auto & other = m_Nodes[node].edge;
+	auto comparison = compare(other, sweepPoint);
+	if (comparison == 0) {
+		return edge.getIndex() < other.getIndex();
+	}
+	return comparison > 0;
+}
+
+// Xorshift, deterministic and cheap, which is all we need for treap priorities.
+std::uint32_t ofSplitToMonotone::SweepLineStatus::nextPriority() {
+	m_PrioritySeed += 0x9E3779B9u;
+	auto x = m_PrioritySeed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+index_t ofSplitToMonotone::SweepLineStatus::insert(index_t root, index_t node, const position_t & sweepPoint) {
+	if (root == k_NullNode) {
+		return node;
+	}
+
+	if (isLeftOf(m_Nodes[node].edge, sweepPoint, root)) {
+		m_Nodes[root].left = insert(m_Nodes[root].left, node, sweepPoint);
+		if (m_Nodes[m_Nodes[root].left].priority > m_Nodes[root].priority) {
+			root = rotateRight(root);
+		}
+	} else {
+		m_Nodes[root].right = insert(m_Nodes[root].right, node, sweepPoint);
+		if (m_Nodes[m_Nodes[root].right].priority > m_Nodes[root].priority) {
+			root = rotateLeft(root);
+		}
+	}
+
+	return root;
+}
+
+index_t ofSplitToMonotone::SweepLineStatus::erase(index_t root, const ofDoublyConnectedEdgeList::HalfEdge & edge, const position_t & sweepPoint, bool & found) {
+	if (root == k_NullNode) {
+		return root;
+	}
+
+	if (m_Nodes[root].edge == edge) {
+		found = true;
+		m_FreeNodes.push_back(root);
+		return join(m_Nodes[root].left, m_Nodes[root].right);
+	}
+
+	// Look on both sides of equal keys, rounding may tie edges along the sweep line.
+	auto comparison = compare(m_Nodes[root].edge, sweepPoint);
+
+	if (comparison >= 0) {
+		m_Nodes[root].left = erase(m_Nodes[root].left, edge, sweepPoint, found);
+	}
+
+	if (!found && comparison <= 0) {
+		m_Nodes[root].right = erase(m_Nodes[root].right, edge, sweepPoint, found);
+	}
+
+	return root;
+}
+
+// Joins two trees, all the edges of the left one being left of the edges of the right one.
+index_t ofSplitToMonotone::SweepLineStatus::join(index_t left, index_t right) {
+	if (left == k_NullNode) {
+		return right;
+	}
+
+	if (right == k_NullNode) {
+		return left;
+	}
+
+	if (m_Nodes[left].priority > m_Nodes[right].priority) {
+		m_Nodes[left].right = join(m_Nodes[left].right, right);
+		return left;
+	}
+
+	m_Nodes[right].left = join(left, m_Nodes[right].left);
+	return right;
+}
+
+index_t ofSplitToMonotone::SweepLineStatus::rotateLeft(index_t root) {
+	auto pivot = m_Nodes[root].right;
+	m_Nodes[root].right = m_Nodes[pivot].left;
+	m_Nodes[pivot].left = root;
+	return pivot;
+}
+
+index_t ofSplitToMonotone::SweepLineStatus::rotateRight(index_t root) {
+	auto pivot = m_Nodes[root].left;
+	m_Nodes[root].left = m_Nodes[pivot].right;
+	m_Nodes[pivot].right = root;
+	return pivot;
+}
+
+bool ofSplitToMonotone::isMerge(const ofDoublyConnectedEdgeList::HalfEdge & helper) const {
+	return m_VerticesType[helper.getOrigin().getIndex()] == ofSplitToMonotone::VertexType::Merge;
+}
+
+// Diagonals are added from the vertex incident edge, the only edge of the vertex as long as it has no diagonal.
+// When adding an half edge from edge A to edge B, the new edge follows A's previous edge and leads to B,
+// while its twin follows B's previous edge and leads to A.
+// This is how we know which half edge of the vertex bounds each side of the diagonal.
+
 void ofSplitToMonotone::diagonalToPreviousEdgeHelper(
 	ofDoublyConnectedEdgeList & dcel,
 	ofDoublyConnectedEdgeList::Vertex & vertex) {
 	auto prevEdge = vertex.getIncidentEdge().getPrev();
 	auto helper = m_SweepLineStatus.getHelper(prevEdge);
 
-	if (m_VerticesClassification[helper.getIndex()] == ofSplitToMonotone::VertexType::Merge) {
-		dcel.addHalfEdge(vertex, helper);
+	if (isMerge(helper)) {
+		dcel.addHalfEdge(vertex.getIncidentEdge(), helper);
 	}
 
 	m_SweepLineStatus.remove(prevEdge);
@@ -43,66 +346,113 @@ void ofSplitToMonotone::diagonalToPreviousEdgeHelper(
 void ofSplitToMonotone::diagonalToLeftEdgeHelper(
 	ofDoublyConnectedEdgeList & dcel,
 	ofDoublyConnectedEdgeList::Vertex & vertex) {
-	auto leftEdge = m_SweepLineStatus.findLeft(vertex);
-	auto leftHelper = m_SweepLineStatus.getHelper(leftEdge);
-	if (m_VerticesClassification[leftHelper.getIndex()] == ofSplitToMonotone::VertexType::Merge) {
-		dcel.addHalfEdge(vertex, leftHelper);
+	auto & leftHelper = m_SweepLineStatus.findLeftHelper(vertex);
+
+	// Without a diagonal, the region right of the left edge is the one the incident edge bounds.
+	if (isMerge(leftHelper)) {
+		leftHelper = dcel.addHalfEdge(vertex.getIncidentEdge(), leftHelper);
+	} else {
+		leftHelper = vertex.getIncidentEdge();
 	}
+}
 
-	m_SweepLineStatus.updateHelper(leftEdge, vertex);
+void ofSplitToMonotone::reserve(std::size_t numVertices) {
+	m_VerticesClassification.reserve(numVertices);
+	m_SweepKeys.reserve(numVertices);
+	m_SweepKeysScratch.reserve(numVertices);
+	m_SweepLineStatus.reserve(numVertices);
 }
 
-void ofSplitToMonotone::execute(ofDoublyConnectedEdgeList & dcel, ofDoublyConnectedEdgeList::Face & face) {
-	m_VerticesClassification.resize(dcel.getNumVertices());
-	
-	// Collect and label vertices on face.
-	auto edge = face.getOuterComponent();
-	do {
-		auto vertex = edge.getOrigin();
-		m_Vertices.push_back(vertex);
-		m_VerticesClassification[vertex.getIndex()] = classifyVertex(vertex);
-		edge = edge.getNext();
-	} while (edge != face.getOuterComponent());
+void ofSplitToMonotone::execute(ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face & face) {
+	execute(dcel, face, nullptr);
+}
+
+void ofSplitToMonotone::execute(
+	ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face & face, const VertexType * verticesClassification) {
+	const auto isInitialPolygon = dcel.isInitialPolygon();
+	if (verticesClassification != nullptr && !isInitialPolygon) {
+		throw std::runtime_error("Vertices can only be classified upfront on the initial polygon.");
+	}
+
+	reserve(dcel.getNumVertices());
+	// A failed execution may have left state behind.
+	m_SweepLineStatus.clear();
+	m_SweepKeys.clear();
+
+	{
+		OF_POLYGON_STATS_SCOPE(m_Stats, classification);
+
+		// The initial polygon is labelled in a dense pass over positions, unless the caller did.
+		const auto isClassified = verticesClassification != nullptr;
+		if (!isClassified) {
+			m_VerticesClassification.resize(dcel.getNumVertices());
+
+			if (isInitialPolygon) {
+				ofPolygonClassifyVertices(dcel.getPositions(), dcel.getNumVertices(), m_VerticesClassification.data(), m_SweepLineStatus.getRobustPredicates());
+			}
+		}
+
+		// Collect and label vertices on face.
+		// Incident edges are set to the face edges as we'll add diagonals starting from them.
+		auto edge = face.getOuterComponent();
+		do {
+			auto vertex = edge.getOrigin();
+			vertex.setIncidentEdge(edge);
+			m_SweepKeys.emplace_back(vertex);
+			if (!isInitialPolygon) {
+				m_VerticesClassification[vertex.getIndex()] = classifyVertex(vertex, m_SweepLineStatus.getRobustPredicates());
+			}
+			edge = edge.getNext();
+		} while (edge != face.getOuterComponent());
+	}
+
+	m_VerticesType = verticesClassification != nullptr ? verticesClassification : m_VerticesClassification.data();
 
 	// Sort vertices according to sweep line.
-	std::sort(m_Vertices.begin(), m_Vertices.end(), ofVertexSweepComparer());
+	{
+		OF_POLYGON_STATS_SCOPE(m_Stats, sort);
+		sortSweepKeys(m_SweepKeys, m_SweepKeysScratch);
+	}
+
+	OF_POLYGON_STATS_SCOPE(m_Stats, sweep);
+
+	for (const auto & key : m_SweepKeys) {
+		auto vertex = ofDoublyConnectedEdgeList::Vertex(&dcel, key.vertex);
 
-	for (auto it = m_Vertices.begin(); it != m_Vertices.end(); ++it) {
 		// update comparer with sweep line position
-		m_SweepLineStatus.setCoordinate(it->getY());
+		m_SweepLineStatus.setCoordinate(vertex.getY());
 
-		switch (m_VerticesClassification[it->getIndex()]) {
+		switch (m_VerticesType[key.vertex]) {
 		case ofSplitToMonotone::VertexType::Start: {
-			m_SweepLineStatus.emplace(it->getIncidentEdge(), *it);
+			m_SweepLineStatus.emplace(vertex.getIncidentEdge(), vertex.getIncidentEdge());
 		} break;
 
 		case ofSplitToMonotone::VertexType::Stop: {
-			diagonalToPreviousEdgeHelper(dcel, *it);
+			diagonalToPreviousEdgeHelper(dcel, vertex);
 		} break;
 
 		case ofSplitToMonotone::VertexType::Split: {
-			auto vertex = *it;
-			auto leftEdge = m_SweepLineStatus.findLeft(vertex);
-			auto leftHelper = m_SweepLineStatus.getHelper(leftEdge);
-			dcel.addHalfEdge(vertex, leftHelper);
-			m_SweepLineStatus.updateHelper(leftEdge, vertex);
-			m_SweepLineStatus.emplace(vertex.getIncidentEdge(), vertex);
+			OF_POLYGON_STATS_ADD(m_Stats, numSplitVertices, 1);
+			auto & leftHelper = m_SweepLineStatus.findLeftHelper(vertex);
+			// The new edge bounds the region left of the diagonal, the incident edge the one right of it.
+			leftHelper = dcel.addHalfEdge(vertex.getIncidentEdge(), leftHelper);
+			m_SweepLineStatus.emplace(vertex.getIncidentEdge(), vertex.getIncidentEdge());
 		} break;
 
 		case ofSplitToMonotone::VertexType::Merge: {
-			diagonalToPreviousEdgeHelper(dcel, *it);
-			diagonalToLeftEdgeHelper(dcel, *it);
+			OF_POLYGON_STATS_ADD(m_Stats, numMergeVertices, 1);
+			diagonalToPreviousEdgeHelper(dcel, vertex);
+			diagonalToLeftEdgeHelper(dcel, vertex);
 		} break;
 
 		case ofSplitToMonotone::VertexType::Regular: {
-			auto vertex = *it;
 			auto direction = vertex.getIncidentEdge().getDirection();
 			auto isRight = direction.y == 0.0 ? direction.x > 0.0 : direction.y < 0;
 
 			// If the interior of the polygon lies to the right of vertex.
 			if (isRight) {
 				diagonalToPreviousEdgeHelper(dcel, vertex);
-				m_SweepLineStatus.emplace(vertex.getIncidentEdge(), vertex);
+				m_SweepLineStatus.emplace(vertex.getIncidentEdge(), vertex.getIncidentEdge());
 			} else {
 				diagonalToLeftEdgeHelper(dcel, vertex);
 			}
@@ -112,5 +462,6 @@ void ofSplitToMonotone::execute(ofDoublyConnectedEdgeList & dcel, ofDoublyConnec
 
 	m_SweepLineStatus.clear();
 	m_VerticesClassification.clear();
-	m_Vertices.clear();
+	m_VerticesType = nullptr;
+	m_SweepKeys.clear();
 }
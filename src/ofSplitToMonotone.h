@@ -3,17 +3,31 @@
 #pragma once
 
 #include "ofHalfEdgeSweepComparer.h"
+#include "ofPolygonTriangulationStats.h"
+#include "ofVertexSweepComparer.h"
 #include <algorithm>
+#include <cstdint>
 #include <limits>
-#include <unordered_map>
 #include <stdexcept>
 #include <vector>
 
 /// @brief A class implementing the split of a polygon into monotone polygons.
 class ofSplitToMonotone {
 public:
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	ofSplitToMonotone() = default;
+
+	/// @brief Creates an instance allocating its scratch memory from a memory resource.
+	/// @param resource The memory resource, which must outlive the instance.
+	explicit ofSplitToMonotone(ofPolygonMemoryResource * resource)
+		: m_SweepLineStatus(resource)
+		, m_VerticesClassification(resource)
+		, m_SweepKeys(resource)
+		, m_SweepKeysScratch(resource) { }
+#endif
+
 	/// @brief Vertex classification when splitting a polygon to monotone polygons.
-	enum class VertexType {
+	enum class VertexType : std::uint8_t {
 		/// @brief A vertex whose neighbors lie below and the interior angle is less than pi.
 		Start,
 		/// @brief A vertex whose neighbors lie above and the interior angle is less than pi.
@@ -28,104 +42,148 @@ public:
 
 	/// @brief Classify a vertex for splitting to monotone.
 	/// @param vertex The vertex.
+	/// @param robustPredicates Whether the turn at the vertex is evaluated exactly.
 	/// @return The classification.
 	///
 	/// This is mainly exposed for unit tests.
-	static VertexType classifyVertex(const ofDoublyConnectedEdgeList::Vertex & vertex);
+	static VertexType classifyVertex(const ofDoublyConnectedEdgeList::Vertex & vertex, bool robustPredicates = false);
+
+	/// @brief Classify a vertex for splitting to monotone, given its neighbors and the sign of the turn.
+	/// @param prev The position of the previous vertex along the polygon.
+	/// @param vertex The position of the vertex.
+	/// @param next The position of the next vertex along the polygon.
+	/// @param isConvex Whether the interior angle at the vertex is less than pi.
+	/// @return The classification.
+	static VertexType classifyTurn(const position_t & prev, const position_t & vertex, const position_t & next, bool isConvex);
 
 	/// @brief Split a face of a doubly connected edge list into monotone polygons.
 	/// @param dcel The doubly connected edge list.
 	/// @param face The face.
-	void execute(ofDoublyConnectedEdgeList & dcel, ofDoublyConnectedEdgeList::Face & face);
+	///
+	/// The incident edges of the vertices of the face are set to their half edges on the face.
+	/// Diagonals are added between half edges, so the doubly connected edge list may defer face assignment.
+	/// Once a polygon has been processed, processing polygons with as many vertices or less does not allocate memory.
+	void execute(ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face & face);
 
-private:
+	/// @brief Split the initial polygon of a doubly connected edge list into monotone polygons, its vertices already classified.
+	/// @param dcel The doubly connected edge list, holding the initial polygon.
+	/// @param face The face.
+	/// @param verticesClassification The classification of each vertex, indexed by vertex, as computed by ofPolygonClassifyVertices().
+	///
+	/// Saves classifying vertices again when the caller already did. Throws if the doubly connected edge list holds diagonals.
+	void execute(ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face & face, const VertexType * verticesClassification);
+
+	/// @brief Reserves memory for splitting polygons with up to a given number of vertices.
+	/// @param numVertices The number of vertices.
+	void reserve(std::size_t numVertices);
+
+	/// @brief Sets whether geometric predicates are evaluated exactly.
+	/// @param robustPredicates True to use exact predicates, false by default.
+	///
+	/// With large coordinates, rounding may misorder edges along the sweep line or misclassify vertices,
+	/// leading to failures. Exact predicates avoid that for a small cost, see ofOrient2dAdaptive.
+	inline void setRobustPredicates(bool robustPredicates) { m_SweepLineStatus.setRobustPredicates(robustPredicates); }
+
+	/// @brief Returns whether geometric predicates are evaluated exactly.
+	inline bool getRobustPredicates() const { return m_SweepLineStatus.getRobustPredicates(); }
+
+	/// @brief Sets the stats filled when splitting polygons.
+	/// @param stats The stats, which must outlive their use, or null to stop filling them.
+	///
+	/// Accounts for the classification, sort and sweep, and the split and merge vertices met.
+	/// Only filled when OF_POLYGON_TRIANGULATION_STATS is defined, see ofPolygonTriangulationStats.h.
+	inline void setStats(ofPolygonTriangulationStats * stats) { m_Stats = stats; }
+
+	/// @brief Returns the stats filled when splitting polygons, null if none.
+	inline ofPolygonTriangulationStats * getStats() const { return m_Stats; }
+
+	/// @brief Edges crossing the sweep line, ordered from left to right.
+	///
+	/// Stored in a treap, a binary search tree kept balanced by random priorities,
+	/// so that insertion, removal and finding the edge left of a vertex are O(log n).
+	/// This is mainly exposed for unit tests.
 	class SweepLineStatus {
 	public:
-		float getCoordinate() const { return m_Coordinate; }
-		void setCoordinate(float coordinate) { m_Coordinate = coordinate; }
-
-		void clear() {
-			m_EdgeToHelperMap.clear();
-			m_HalfEdges.clear();
-		}
-
-		ofDoublyConnectedEdgeList::Vertex getHelper(const ofDoublyConnectedEdgeList::HalfEdge & edge) {
-			auto it = m_EdgeToHelperMap.find(edge);
-
-			if (it == m_EdgeToHelperMap.end()) {
-				throw std::runtime_error("Could not find helper.");
-			}
-
-			return it->second;
-		}
-
-		// Find the edge directly to the left.
-		ofDoublyConnectedEdgeList::HalfEdge findLeft(ofDoublyConnectedEdgeList::Vertex vertex) {
-			auto oneOrMoreIntersectionFound = false;
-			auto lastIntersectX = -std::numeric_limits<float>::max();
-			ofDoublyConnectedEdgeList::HalfEdge leftEdge;
-
-			for (auto it = m_HalfEdges.begin(); it != m_HalfEdges.end(); ++it) {
-				auto edge = *it;
-				if (edge.getDestination() == vertex) {
-					continue;
-				}
-
-				auto intersectionFound = false;
-				auto intersect = ofHalfEdgeSweepComparer::sweepIntersection(edge, m_Coordinate, intersectionFound);
-				if (intersectionFound && vertex.getX() > intersect.x && intersect.x > lastIntersectX) {
-					oneOrMoreIntersectionFound = true;
-					lastIntersectX = intersect.x;
-					leftEdge = edge;
-				}
-			}
-
-			if (!oneOrMoreIntersectionFound) {
-				throw std::runtime_error("Could not find left edge.");
-			}
-
-			return leftEdge;
-		}
-
-		void emplace(ofDoublyConnectedEdgeList::HalfEdge edge, ofDoublyConnectedEdgeList::Vertex helper) {
-			m_EdgeToHelperMap.emplace(edge, helper);
-			// Keep the collection sorted.
-			auto insertion = std::upper_bound(m_HalfEdges.begin(), m_HalfEdges.end(), edge, ofHalfEdgeSweepComparer(m_Coordinate));
-			m_HalfEdges.insert(insertion, edge);
-		}
-
-		void remove(ofDoublyConnectedEdgeList::HalfEdge edge) {
-			m_EdgeToHelperMap.erase(edge);
-			auto removal = std::remove(m_HalfEdges.begin(), m_HalfEdges.end(), edge);
-			m_HalfEdges.erase(removal, m_HalfEdges.end());
-		}
-
-		void updateHelper(ofDoublyConnectedEdgeList::HalfEdge edge, ofDoublyConnectedEdgeList::Vertex helper) {
-			auto it = m_EdgeToHelperMap.find(edge);
-
-			if (it == m_EdgeToHelperMap.end()) {
-				throw std::runtime_error("Could not find helper edge for update.");
-			}
-
-			m_EdgeToHelperMap[edge] = helper;
-		}
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+		SweepLineStatus() = default;
+
+		explicit SweepLineStatus(ofPolygonMemoryResource * resource)
+			: m_Nodes(resource)
+			, m_FreeNodes(resource)
+			, m_EdgeNodes(resource) { }
+#endif
+
+		scalar_t getCoordinate() const { return m_Coordinate; }
+		void setCoordinate(scalar_t coordinate) { m_Coordinate = coordinate; }
+
+		// Edges are then ordered by orientation tests rather than by their rounded intersection with the sweep line.
+		bool getRobustPredicates() const { return m_RobustPredicates; }
+		void setRobustPredicates(bool robustPredicates) { m_RobustPredicates = robustPredicates; }
+
+		void clear();
+
+		// Reserve memory so that sweeping a polygon with up to that many vertices does not allocate.
+		void reserve(std::size_t numVertices);
+
+		// Edges passed to the status meet the sweep line at the vertex being processed.
+
+		// The helper is stored as its half edge bounding the region right of the edge, below the helper.
+		// This lets us add diagonals to the helper without looking for the face it shares with the current vertex.
+		// Found in constant time, the node of the edge being known.
+		ofDoublyConnectedEdgeList::HalfEdge getHelper(const ofDoublyConnectedEdgeList::HalfEdge & edge);
+
+		// Find the helper of the edge directly to the left, which may be updated in place until the status is modified.
+		ofDoublyConnectedEdgeList::HalfEdge & findLeftHelper(ofDoublyConnectedEdgeList::Vertex vertex);
+
+		void emplace(ofDoublyConnectedEdgeList::HalfEdge edge, ofDoublyConnectedEdgeList::HalfEdge helper);
+
+		void remove(ofDoublyConnectedEdgeList::HalfEdge edge);
 
 	private:
-		// We know that the index is enough to compute the key's hash.
-		struct ConstantHalfEdgeHash {
-			std::size_t operator()(ofDoublyConnectedEdgeList::HalfEdge const & s) const {
-				return s.getIndex();
-			}
+		// The helper lives in the tree node of its edge, no separate allocation is needed.
+		struct Node {
+			ofDoublyConnectedEdgeList::HalfEdge edge;
+			ofDoublyConnectedEdgeList::HalfEdge helper;
+			std::uint32_t priority;
+			index_t left;
+			index_t right;
 		};
 
-		std::unordered_map<ofDoublyConnectedEdgeList::HalfEdge, ofDoublyConnectedEdgeList::Vertex, ConstantHalfEdgeHash> m_EdgeToHelperMap;
-		std::vector<ofDoublyConnectedEdgeList::HalfEdge> m_HalfEdges;
-		float m_Coordinate;
+		static constexpr index_t k_NullNode = std::numeric_limits<index_t>::max();
+
+		// Nodes are recycled, which avoids allocations once the status has been used.
+		ofPolygonVector<Node> m_Nodes;
+		ofPolygonVector<index_t> m_FreeNodes;
+		// Node of each half edge crossing the sweep line, indexed by half edge, k_NullNode for others.
+		ofPolygonVector<index_t> m_EdgeNodes;
+		index_t m_Root { k_NullNode };
+		std::uint32_t m_PrioritySeed { 0 };
+		scalar_t m_Coordinate;
+		bool m_RobustPredicates { false };
+
+		ofPolygonReal_t<scalar_t> getSweepX(const ofDoublyConnectedEdgeList::HalfEdge & edge) const;
+		position_t getSweepPoint(const ofDoublyConnectedEdgeList::HalfEdge & edge) const;
+		int compare(const ofDoublyConnectedEdgeList::HalfEdge & edge, const position_t & sweepPoint) const;
+		bool isLeftOf(const ofDoublyConnectedEdgeList::HalfEdge & edge, const position_t & sweepPoint, index_t node) const;
+		std::uint32_t nextPriority();
+		index_t insert(index_t root, index_t node, const position_t & sweepPoint);
+		index_t erase(index_t root, const ofDoublyConnectedEdgeList::HalfEdge & edge, const position_t & sweepPoint, bool & found);
+		index_t join(index_t left, index_t right);
+		index_t rotateLeft(index_t root);
+		index_t rotateRight(index_t root);
 	};
 
+private:
 	SweepLineStatus m_SweepLineStatus;
-	std::vector<VertexType> m_VerticesClassification;
-	std::vector<ofDoublyConnectedEdgeList::Vertex> m_Vertices;
+	ofPolygonVector<VertexType> m_VerticesClassification;
+	// The classification in use by the current execution, owned by the caller or pointing to the member above.
+	const VertexType * m_VerticesType { nullptr };
+	// Vertices of the face in sweep order, the scratch is used by the radix sort.
+	ofPolygonVector<ofVertexSweepKey> m_SweepKeys;
+	ofPolygonVector<ofVertexSweepKey> m_SweepKeysScratch;
+	ofPolygonTriangulationStats * m_Stats { nullptr };
+
+	bool isMerge(const ofDoublyConnectedEdgeList::HalfEdge & helper) const;
 
 	void diagonalToPreviousEdgeHelper(
 		ofDoublyConnectedEdgeList & dcel,
@@ -1,21 +1,21 @@
 #include <cassert>
-#include <glm/gtx/vector_angle.hpp>
+#include "ofPolygonPredicates.h"
 #include "ofTriangulateMonotone.h"
 #include "ofVertexSweepComparer.h"
 
 bool isInside(
 	const ofDoublyConnectedEdgeList::Vertex & vertex,
+	bool isLeft,
 	const ofDoublyConnectedEdgeList::Vertex & stackTop,
-	const ofDoublyConnectedEdgeList::Vertex & lastPopped) {
-	// Equivalent to calculating the interior angle.
-	auto angle = glm::orientedAngle(
-		glm::normalize(lastPopped.getPosition() - vertex.getPosition()),
-		glm::normalize(stackTop.getPosition() - vertex.getPosition()));
-
-	if (vertex.getChain() == ofDoublyConnectedEdgeList::Chain::Left) {
-		return angle < 0.0f;
+	const ofDoublyConnectedEdgeList::Vertex & lastPopped,
+	bool robustPredicates) {
+	// The sign of the angle from the last popped vertex to the top of the stack, around the current vertex.
+	auto orientation = ofOrient2d(vertex.getPosition(), lastPopped.getPosition(), stackTop.getPosition(), robustPredicates);
+
+	if (isLeft) {
+		return orientation < 0.0;
 	}
-	return angle > 0.0f;
+	return orientation > 0.0;
 }
 
 void getTopAndBottomVertices(
@@ -39,133 +39,177 @@ void getTopAndBottomVertices(
 	} while (halfEdgesIterator.moveNext());
 }
 
-void labelChains(const ofDoublyConnectedEdgeList::HalfEdge & top, const ofDoublyConnectedEdgeList::HalfEdge & bottom) {
-	// Label top vertex;
+void ofTriangulateMonotone::sortSweepMonotone(
+	ofPolygonVector<ChainEdge> & halfEdges,
+	ofDoublyConnectedEdgeList::HalfEdge & top,
+	ofDoublyConnectedEdgeList::HalfEdge & bottom) {
+	// We'll receive the left chain from the top and the right chain from the bottom.
+	// To merge we'll start from the top.
+	// Each vertex is labelled with the chain (left or right) it belongs to as we go.
 	auto edge = top;
-	edge.getOrigin().setChain(ofDoublyConnectedEdgeList::Chain::Top);
+
+	// Left chain, read from the front.
+	m_LeftChain.push_back({ edge, ofDoublyConnectedEdgeList::Chain::Top });
 	edge = edge.getNext();
 
-	// Label left chain.
 	while (edge != bottom) {
-		edge.getOrigin().setChain(ofDoublyConnectedEdgeList::Chain::Left);
+		m_LeftChain.push_back({ edge, ofDoublyConnectedEdgeList::Chain::Left });
 		edge = edge.getNext();
 	}
 
-	// Label bottom vertex;
-	edge.getOrigin().setChain(ofDoublyConnectedEdgeList::Chain::Bottom);
+	// Right chain, read from the back.
+	m_RightChain.push_back({ edge, ofDoublyConnectedEdgeList::Chain::Bottom });
 	edge = edge.getNext();
 
-	// Label right chain.
 	while (edge != top) {
-		edge.getOrigin().setChain(ofDoublyConnectedEdgeList::Chain::Right);
+		m_RightChain.push_back({ edge, ofDoublyConnectedEdgeList::Chain::Right });
 		edge = edge.getNext();
 	}
-}
-
-void ofTriangulateMonotone::sortSweepMonotone(
-	std::vector<ofDoublyConnectedEdgeList::Vertex> & vertices,
-	ofDoublyConnectedEdgeList::HalfEdge & top,
-	ofDoublyConnectedEdgeList::HalfEdge & bottom) {
-	// We use a queue for the left chain as we'll receive top vertices first.
-	// We use a stack for the right chain as we'll receive bottom vertices first.
-	// To merge we'll start from the top.
-	auto edge = top;
-
-	// Left chain goes in the queue.
-	do {
-		m_SweepQueue.push(edge.getOrigin());
-		edge = edge.getNext();
-	} while (edge != bottom);
-
-	// Right chain goes in the stack.
-	do {
-		m_SweepStack.push(edge.getOrigin());
-		edge = edge.getNext();
-	} while (edge != top);
 
 	// Merge chains.
-	while (!m_SweepQueue.empty() && !m_SweepStack.empty()) {
-		if (ofVertexSweepComparer()(m_SweepQueue.front(), m_SweepStack.top())) {
-			vertices.push_back(m_SweepQueue.front());
-			m_SweepQueue.pop();
+	auto left = m_LeftChain.begin();
+	while (left != m_LeftChain.end() && !m_RightChain.empty()) {
+		if (ofVertexSweepComparer()(left->halfEdge.getOrigin(), m_RightChain.back().halfEdge.getOrigin())) {
+			halfEdges.push_back(*left);
+			++left;
 		} else {
-			vertices.push_back(m_SweepStack.top());
-			m_SweepStack.pop();
+			halfEdges.push_back(m_RightChain.back());
+			m_RightChain.pop_back();
 		}
 	}
 
 	// Add remaining vertices if any.
-	while (!m_SweepQueue.empty()) {
-		vertices.push_back(m_SweepQueue.front());
-		m_SweepQueue.pop();
-	}
+	halfEdges.insert(halfEdges.end(), left, m_LeftChain.end());
+	halfEdges.insert(halfEdges.end(), m_RightChain.rbegin(), m_RightChain.rend());
 
-	while (!m_SweepStack.empty()) {
-		vertices.push_back(m_SweepStack.top());
-		m_SweepStack.pop();
-	}
+	m_LeftChain.clear();
+	m_RightChain.clear();
 }
 
-void ofTriangulateMonotone::execute(ofDoublyConnectedEdgeList & dcel, ofDoublyConnectedEdgeList::Face & face) {
+void ofTriangulateMonotone::reserve(std::size_t numVertices) {
+	m_HalfEdges.reserve(numVertices);
+	m_HalfEdgeStack.reserve(numVertices);
+	m_LeftChain.reserve(numVertices);
+	m_RightChain.reserve(numVertices);
+}
+
+// Each vertex is represented by its half edge on the remaining polygon, the part not yet triangulated.
+// When adding an half edge from edge A (current vertex) to edge B (stacked vertex),
+// the new edge follows A's previous edge and leads to B, while its twin follows B's previous edge and leads to A.
+// If the current vertex is on the left chain, the remaining polygon is on the twin side:
+// the current vertex keeps its half edge and the stacked vertex is now represented by the twin.
+// If the current vertex is on the right chain, the remaining polygon is on the new edge side:
+// the current vertex is now represented by the new edge and the stacked vertex keeps its half edge.
+
+template <class AddDiagonal>
+void ofTriangulateMonotone::execute(
+	ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face & face, AddDiagonal addDiagonal) {
 	ofDoublyConnectedEdgeList::HalfEdge top;
 	ofDoublyConnectedEdgeList::HalfEdge bottom;
 	getTopAndBottomVertices(face, top, bottom);
 
-	// Label each vertex with the chain (left or right) it belongs to.
-	labelChains(top, bottom);
-
-	sortSweepMonotone(m_Vertices, top, bottom);
+	reserve(dcel.getNumVertices());
+	sortSweepMonotone(m_HalfEdges, top, bottom);
 
 	// The stack holds vertices we still (possibly) have edges to connect to.
-	m_VertexStack.push(m_Vertices[0]);
-	m_VertexStack.push(m_Vertices[1]);
+	m_HalfEdgeStack.push_back(m_HalfEdges[0]);
+	m_HalfEdgeStack.push_back(m_HalfEdges[1]);
+
+	for (std::size_t i = 2; i != m_HalfEdges.size() - 1; ++i) {
+		auto edge = m_HalfEdges[i].halfEdge;
+		auto chain = m_HalfEdges[i].chain;
+		auto vertex = edge.getOrigin();
+		auto isLeft = chain == ofDoublyConnectedEdgeList::Chain::Left;
 
-	for (auto i = 2; i != m_Vertices.size() - 1; ++i) {
 		// If current vertex and the vertex on top of stack are on different chains.
-		if (m_Vertices[i].getChain() != m_VertexStack.top().getChain()) {
+		if (chain != m_HalfEdgeStack.back().chain) {
+			// The first diagonal separates the remaining polygon from the part fanning around the current vertex.
+			auto prevEdge = m_HalfEdgeStack.back();
+			m_HalfEdgeStack.pop_back();
+
+			auto fanEdge = edge;
+			auto diagonal = addDiagonal(edge, prevEdge.halfEdge);
+			if (isLeft) {
+				prevEdge.halfEdge = diagonal.getTwin();
+				fanEdge = diagonal;
+			} else {
+				edge = diagonal;
+			}
+
 			// Add a diagonal for all vertices on the stack except the last one,
 			// for it is connected to the current vertex by an edge.
-			while (m_VertexStack.size() > 1) {
-				dcel.addHalfEdge(m_Vertices[i], m_VertexStack.top());
-				m_VertexStack.pop();
+			while (m_HalfEdgeStack.size() > 1) {
+				diagonal = addDiagonal(fanEdge, m_HalfEdgeStack.back().halfEdge);
+				if (isLeft) {
+					fanEdge = diagonal;
+				}
+				m_HalfEdgeStack.pop_back();
 			}
 			// Clear vertex stack, last vertex is not connected.
-			m_VertexStack.pop();
+			m_HalfEdgeStack.pop_back();
 
 			// Push current vertex and its predecessor on the stack.
-			m_VertexStack.push(m_Vertices[i - 1]);
-			m_VertexStack.push(m_Vertices[i]);
+			m_HalfEdgeStack.push_back(prevEdge);
+			m_HalfEdgeStack.push_back({ edge, chain });
 		} else {
 			// Pop one vertex from the stack, as it shares an edge with the current vertex.
-			auto lastPopped = m_VertexStack.top();
-			m_VertexStack.pop();
+			auto lastPopped = m_HalfEdgeStack.back();
+			m_HalfEdgeStack.pop_back();
 
 			// Pop the other vertices while the diagonal from them to the current vertex is inside the polygon.
 			// Is the vertex at the top of the stack visible from the current vertex?
 			// We can deduce that knowing the previously popped vertex.
-			while (!m_VertexStack.empty() && isInside(m_Vertices[i], m_VertexStack.top(), lastPopped)) {
-				dcel.addHalfEdge(m_Vertices[i], m_VertexStack.top());
-				lastPopped = m_VertexStack.top();
-				m_VertexStack.pop();
+			while (!m_HalfEdgeStack.empty() && isInside(vertex, isLeft, m_HalfEdgeStack.back().halfEdge.getOrigin(), lastPopped.halfEdge.getOrigin(), m_RobustPredicates)) {
+				auto diagonal = addDiagonal(edge, m_HalfEdgeStack.back().halfEdge);
+				if (isLeft) {
+					lastPopped = { diagonal.getTwin(), m_HalfEdgeStack.back().chain };
+				} else {
+					lastPopped = m_HalfEdgeStack.back();
+					edge = diagonal;
+				}
+				m_HalfEdgeStack.pop_back();
 			}
 
 			// Push the last vertex that has been popped back onto the stack.
-			m_VertexStack.push(lastPopped);
+			m_HalfEdgeStack.push_back(lastPopped);
 
 			// Push the current vertex on the stack.
-			m_VertexStack.push(m_Vertices[i]);
+			m_HalfEdgeStack.push_back({ edge, chain });
 		}
 	}
 
 	// Add diagonals from the last vertex to all vertices on the stack except the first and the last one.
-	m_VertexStack.pop();
-
-	while (m_VertexStack.size() > 1) {
-		dcel.addHalfEdge(m_Vertices.back(), m_VertexStack.top());
-		m_VertexStack.pop();
+	// The stacked vertices lie on a single chain, which determines the side of the remaining polygon.
+	auto edge = m_HalfEdges.back().halfEdge;
+	m_HalfEdgeStack.pop_back();
+
+	while (m_HalfEdgeStack.size() > 1) {
+		auto diagonal = addDiagonal(edge, m_HalfEdgeStack.back().halfEdge);
+		if (m_HalfEdgeStack.back().chain == ofDoublyConnectedEdgeList::Chain::Right) {
+			edge = diagonal;
+		}
+		m_HalfEdgeStack.pop_back();
 	}
 	// Clear vertex stack, last vertex is not connected.
-	m_VertexStack.pop();
+	m_HalfEdgeStack.pop_back();
+
+	m_HalfEdges.clear();
+}
+
+void ofTriangulateMonotone::execute(ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face & face) {
+	execute(dcel, face, [&dcel](const ofDoublyConnectedEdgeList::HalfEdge & edgeA, const ofDoublyConnectedEdgeList::HalfEdge & edgeB) {
+		return dcel.addHalfEdge(edgeA, edgeB);
+	});
+}
 
-	m_Vertices.clear();
+void ofTriangulateMonotone::execute(
+	ofDoublyConnectedEdgeList & dcel,
+	const ofDoublyConnectedEdgeList::Face & face,
+	const ofDoublyConnectedEdgeList::HalfEdge & firstEdgePair) {
+	auto edgeIndex = firstEdgePair.getIndex();
+	execute(dcel, face, [&dcel, &edgeIndex](const ofDoublyConnectedEdgeList::HalfEdge & edgeA, const ofDoublyConnectedEdgeList::HalfEdge & edgeB) {
+		auto newEdge = ofDoublyConnectedEdgeList::HalfEdge(&dcel, edgeIndex);
+		edgeIndex += 2;
+		return dcel.addHalfEdge(edgeA, edgeB, newEdge);
+	});
 }
@@ -1,30 +1,83 @@
 #pragma once
 
 #include "ofDoublyConnectedEdgeList.h"
-#include <queue>
-#include <stack>
 #include <utility>
 #include <vector>
 
 /// @brief A class implementing the triangulation of monotone polygons.
 class ofTriangulateMonotone {
 public:
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	ofTriangulateMonotone() = default;
+
+	/// @brief Creates an instance allocating its scratch memory from a memory resource.
+	/// @param resource The memory resource, which must outlive the instance.
+	explicit ofTriangulateMonotone(ofPolygonMemoryResource * resource)
+		: m_HalfEdges(resource)
+		, m_HalfEdgeStack(resource)
+		, m_LeftChain(resource)
+		, m_RightChain(resource) { }
+#endif
+
 	/// @brief Triangulates a face of a doubly connected edge list.
 	/// @param dcel The doubly connected edge list.
 	/// @param face The face.
 	///
 	/// The face is assumed to be monotone.
-	void execute(ofDoublyConnectedEdgeList & dcel, ofDoublyConnectedEdgeList::Face & face);
+	/// Diagonals are added between half edges, so the doubly connected edge list may defer face assignment.
+	void execute(ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face & face);
+
+	/// @brief Triangulates a face of a doubly connected edge list, using half edges allocated beforehand.
+	/// @param dcel The doubly connected edge list.
+	/// @param face The face.
+	/// @param firstEdgePair The first of the n - 3 pairs of half edges allocated for the diagonals of a face of n vertices.
+	///
+	/// The doubly connected edge list must defer face assignment.
+	/// Only the face and the allocated half edges are written to, so distinct faces may be triangulated concurrently,
+	/// each by its own instance.
+	void execute(
+		ofDoublyConnectedEdgeList & dcel,
+		const ofDoublyConnectedEdgeList::Face & face,
+		const ofDoublyConnectedEdgeList::HalfEdge & firstEdgePair);
+
+	/// @brief Reserves memory for triangulating polygons with up to a given number of vertices.
+	/// @param numVertices The number of vertices.
+	///
+	/// Once a polygon has been triangulated, triangulating polygons with as many vertices or less does not allocate memory.
+	void reserve(std::size_t numVertices);
+
+	/// @brief Sets whether geometric predicates are evaluated exactly.
+	/// @param robustPredicates True to use exact predicates, false by default.
+	inline void setRobustPredicates(bool robustPredicates) { m_RobustPredicates = robustPredicates; }
+
+	/// @brief Returns whether geometric predicates are evaluated exactly.
+	inline bool getRobustPredicates() const { return m_RobustPredicates; }
 
 private:
-	std::vector<ofDoublyConnectedEdgeList::Vertex> m_Vertices;
-	std::stack<ofDoublyConnectedEdgeList::Vertex> m_VertexStack;
+	// Vertices are manipulated through their half edge on the polygon being triangulated,
+	// which lets us add diagonals without looking for the face shared by two vertices.
+	// The chain of each vertex is kept along with its half edge rather than on the vertex,
+	// as a vertex may belong to several faces triangulated concurrently.
+	struct ChainEdge {
+		ofDoublyConnectedEdgeList::HalfEdge halfEdge;
+		ofDoublyConnectedEdgeList::Chain chain;
+	};
 
-	std::stack<ofDoublyConnectedEdgeList::Vertex> m_SweepStack;
-	std::queue<ofDoublyConnectedEdgeList::Vertex> m_SweepQueue;
+	// Vectors rather than std::stack and std::queue, as deque based containers release and reallocate blocks as they are used.
+	ofPolygonVector<ChainEdge> m_HalfEdges;
+	ofPolygonVector<ChainEdge> m_HalfEdgeStack;
+
+	ofPolygonVector<ChainEdge> m_LeftChain;
+	ofPolygonVector<ChainEdge> m_RightChain;
+
+	bool m_RobustPredicates { false };
 
 	void sortSweepMonotone(
-		std::vector<ofDoublyConnectedEdgeList::Vertex> & vertices,
+		ofPolygonVector<ChainEdge> & halfEdges,
 		ofDoublyConnectedEdgeList::HalfEdge & top,
 		ofDoublyConnectedEdgeList::HalfEdge & bottom);
+
+	// Private template, the functor adds a diagonal between two half edges and returns it.
+	template <class AddDiagonal>
+	void execute(ofDoublyConnectedEdgeList & dcel, const ofDoublyConnectedEdgeList::Face & face, AddDiagonal addDiagonal);
 };
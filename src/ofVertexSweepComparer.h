@@ -1,6 +1,9 @@
 #pragma once
 
 #include "ofDoublyConnectedEdgeList.h"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 /// @brief A functor implementing the comparison of vertices.
 struct ofVertexSweepComparer {
@@ -16,3 +19,42 @@ struct ofVertexSweepComparer {
 		return last.getY() < first.getY();
 	}
 };
+
+/// @brief A vertex sort key, ordering vertices as ofVertexSweepComparer does.
+///
+/// Coordinates are mapped to unsigned integers preserving their order, y being reversed,
+/// so that keys can be radix sorted, by x then by y, without going back to the vertices.
+struct ofVertexSweepKey {
+	using bits_t = std::conditional<sizeof(scalar_t) == sizeof(std::uint64_t), std::uint64_t, std::uint32_t>::type;
+
+	bits_t y;
+	bits_t x;
+	index_t vertex;
+
+	ofVertexSweepKey() = default;
+
+	ofVertexSweepKey(const ofDoublyConnectedEdgeList::Vertex & vertex)
+		: y(~toOrderedBits(vertex.getY()))
+		, x(toOrderedBits(vertex.getX()))
+		, vertex(vertex.getIndex()) { }
+
+	inline bool operator<(const ofVertexSweepKey & other) const {
+		return y == other.y ? x < other.x : y < other.y;
+	}
+
+	/// @brief Maps a coordinate to an unsigned integer, so that unsigned comparison matches the order of coordinates.
+	static inline bits_t toOrderedBits(scalar_t value) {
+		constexpr auto signBit = bits_t(1) << (sizeof(bits_t) * 8 - 1);
+
+		if constexpr (std::is_integral<scalar_t>::value) {
+			return static_cast<bits_t>(value) ^ signBit;
+		} else {
+			// Adding zero turns -0 into +0, as they compare equal.
+			const auto normalized = value + scalar_t(0);
+			bits_t bits;
+			std::memcpy(&bits, &normalized, sizeof(bits));
+			// Negative values grow with their magnitude, flipping all bits reverses them and puts them first.
+			return (bits & signBit) != 0 ? ~bits : bits | signBit;
+		}
+	}
+};
@@ -1,9 +1,61 @@
 #include "ofAppNoWindow.h"
 #include "ofDoublyConnectedEdgeList.h"
 #include "ofMain.h"
+#include "ofOptimizeVertexCache.h"
+#include "ofPolygonBatchTriangulation.h"
+#include "ofPolygonKernels.h"
+#include "ofPolygonPredicates.h"
 #include "ofPolygonTriangulation.h"
 #include "ofPolygonUtility.h"
+#include "ofVertexSweepComparer.h"
 #include "ofxUnitTests.h"
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <thread>
+
+// Allocation accounting, we replace the global allocator to check that reused instances stop allocating.
+namespace {
+std::atomic<std::size_t> s_NumAllocations { 0 };
+}
+
+// Kept out of line, once inlined GCC sees malloc() behind operator new and free() behind operator delete, and flags them as mismatched.
+#if defined(__GNUC__)
+#define OF_NOINLINE __attribute__((noinline))
+#else
+#define OF_NOINLINE
+#endif
+
+OF_NOINLINE void * operator new(std::size_t size) {
+	++s_NumAllocations;
+	auto pointer = std::malloc(size == 0 ? 1 : size);
+	if (pointer == nullptr) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void * operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+OF_NOINLINE void operator delete(void * pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept {
+	operator delete(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept {
+	operator delete(pointer);
+}
+
+void operator delete[](void * pointer, std::size_t) noexcept {
+	operator delete(pointer);
+}
 
 class ofApp : public ofxUnitTestsApp {
 private:
@@ -20,6 +72,27 @@ private:
 		return glm::abs(a - b) < epsilon;
 	}
 
+	// Generated polygons span the unit square, with fixed point coordinates they are scaled up and rounded.
+	static void createPolygonRandom(vector<glm::vec3> & points) {
+		ofPolygonUtility::createPolygonRandom(points);
+		ofPolygonUtility::scaleToScalarRange(points);
+	}
+
+	static void createPolygonRandomMonotone(vector<glm::vec3> & points) {
+		ofPolygonUtility::createPolygonRandomMonotone(points);
+		ofPolygonUtility::scaleToScalarRange(points);
+	}
+
+	static void createPolygonSpiral(vector<glm::vec3> & points) {
+		ofPolygonUtility::createPolygonSpiral(points);
+		ofPolygonUtility::scaleToScalarRange(points);
+	}
+
+	static void createPolygonComb(vector<glm::vec3> & points) {
+		ofPolygonUtility::createPolygonComb(points);
+		ofPolygonUtility::scaleToScalarRange(points);
+	}
+
 public:
 	void TestWindingOrder() {
 		title("Testing Winding Order");
@@ -53,7 +126,7 @@ public:
 			bool trew = false;
 			try {
 				dcel.initializeFromCCWVertices(points);
-			} catch (std::runtime_error error) {
+			} catch (const std::runtime_error &) {
 				trew = true;
 			}
 
@@ -80,6 +153,114 @@ public:
 		ofxTest(ApproximatelyEqual(innerAngle, 1.5f * glm::pi<float>()), "Correct max inner angle.");
 	}
 
+	void TestPseudoAngle() {
+		title("Testing Pseudo Angle");
+
+		auto isMonotonic = true;
+		auto prevPseudoAngle = -1.0f;
+		const auto u = glm::vec2(2, 1);
+		for (auto i = 0; i != 360; ++i) {
+			auto angle = glm::atan(u.y, u.x) + glm::pi<float>() * 2.0f * i / 360;
+			auto pseudoAngle = ofPseudoAngle(u, glm::vec2(glm::cos(angle), glm::sin(angle)) * 3.0f);
+			isMonotonic &= prevPseudoAngle < pseudoAngle && pseudoAngle < 4.0f;
+			prevPseudoAngle = pseudoAngle;
+		}
+		ofxTest(isMonotonic, "Pseudo angle grows with the angle.");
+	}
+
+	void TestVertexSweepKeys() {
+		title("Testing Vertex Sweep Keys");
+
+		vector<glm::vec3> vertices(64);
+		createPolygonSpiral(vertices);
+		auto dcel = ofDoublyConnectedEdgeList();
+		dcel.initializeFromCCWVertices(vertices);
+
+		// Spiral vertices are centered, keys must order negative and positive coordinates alike.
+		auto matchesComparer = true;
+		auto comparer = ofVertexSweepComparer();
+		for (std::size_t i = 0; i != dcel.getNumVertices(); ++i) {
+			for (std::size_t j = 0; j != dcel.getNumVertices(); ++j) {
+				auto first = ofDoublyConnectedEdgeList::Vertex(&dcel, i);
+				auto last = ofDoublyConnectedEdgeList::Vertex(&dcel, j);
+				matchesComparer &= (ofVertexSweepKey(first) < ofVertexSweepKey(last)) == comparer(first, last);
+			}
+		}
+		ofxTest(matchesComparer, "Vertex sweep keys order matches comparer.");
+
+		vertices = { { -0.0f, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 } };
+		dcel.initializeFromCCWVertices(vertices);
+		auto negativeZero = ofVertexSweepKey(ofDoublyConnectedEdgeList::Vertex(&dcel, 0));
+		auto positiveZero = ofVertexSweepKey(ofDoublyConnectedEdgeList::Vertex(&dcel, 3));
+		ofxTest(negativeZero.x == positiveZero.x, "Vertex sweep keys of signed zeros are equal.");
+	}
+
+	void TestScalarTypes() {
+		title("Testing Scalar Types");
+
+		// Products of fixed point coordinates are evaluated on 64 bits, where they are exact.
+		const auto m = (1 << 29) - 1;
+		const auto orientation = ofOrient2d(glm::ivec2(-m, -m), glm::ivec2(m, m - 1), glm::ivec2(m - 1, m));
+		ofxTest(orientation == 4 * static_cast<std::int64_t>(m) - 1, "Fixed point orientation is exact.");
+
+		// Products of double precision coordinates are not, the adaptive predicate completes them.
+		auto isExact = true;
+		const auto a = glm::dvec2(0.5, 0.5);
+		const auto b = glm::dvec2(12.0, 12.0);
+		for (auto i = -8; i <= 8; ++i) {
+			const auto c = glm::dvec2(24.0 + i * std::ldexp(1.0, -48), 24.0);
+			const auto adaptive = ofOrient2dAdaptive(a, b, c);
+			isExact &= i == 0 ? adaptive == 0.0 : (adaptive > 0.0) == (i < 0);
+		}
+		ofxTest(isExact, "Double precision adaptive orientation is exact.");
+
+		// Integral coordinates are represented exactly whatever the scalar type.
+		const vector<double> doubles = { 0, 0, 4, 0, 4, 4, 0, 4 };
+		const vector<std::int32_t> integers = { 0, 0, 4, 0, 4, 4, 0, 4 };
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		dcel.initializeFromCCWVertices(doubles.data(), doubles.size() / 2);
+		auto origin = dcel.getInnerFace().getOuterComponent().getNext().getOrigin();
+		ofxTest(origin.getPosition() == position_t(4, 0), "Positions read from double precision buffer.");
+
+		dcel.initializeFromCCWVertices(integers.data(), integers.size() / 2);
+		origin = dcel.getInnerFace().getOuterComponent().getNext().getNext().getOrigin();
+		ofxTest(origin.getPosition() == position_t(4, 4), "Positions read from fixed point buffer.");
+	}
+
+	void TestIndexTypes() {
+		title("Testing Index Types");
+
+		// The number of vertices is checked before positions are read, whatever the width of indices.
+		const auto maxNumVertices = ofDoublyConnectedEdgeList::getMaxNumVertices();
+		const float coordinates[] = { 0 };
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto trew = false;
+		try {
+			dcel.initializeFromCCWVertices(coordinates, coordinates, maxNumVertices + 1);
+		} catch (const std::runtime_error &) {
+			trew = true;
+		}
+		ofxTest(trew, "Initialize dcel with too many vertices for the index type throws.");
+
+		// Reaching the limit takes a polygon of a quarter of the index range, only done with 16 bits indices.
+		if (maxNumVertices > std::numeric_limits<std::uint16_t>::max()) {
+			return;
+		}
+
+		vector<glm::vec3> vertices(maxNumVertices);
+		createPolygonSpiral(vertices);
+		dcel.initializeFromCCWVertices(vertices);
+		auto polygonTriangulation = ofPolygonTriangulation();
+		polygonTriangulation.setRobustPredicates(true);
+		polygonTriangulation.execute(dcel);
+		ofxTest(dcel.getNumTriangles() == maxNumVertices - 2, "Polygon with the maximal number of vertices is triangulated.");
+
+		vector<std::uint16_t> indices(dcel.getNumTriangles() * 3);
+		dcel.extractTriangles(indices.data());
+		ofxTest(*std::max_element(indices.begin(), indices.end()) == maxNumVertices - 1, "Triangles of the maximal polygon are extracted.");
+	}
+
 	void TestPolygonSimplification() {
 		title("Testing Polygon Simplification");
 
@@ -118,10 +299,11 @@ public:
 		auto innerFace = dcel.getInnerFace();
 
 		auto edgeIt = ofDoublyConnectedEdgeList::HalfEdgesIterator(innerFace);
-		auto count = 0;
+		auto count = std::size_t { 0 };
 		do {
 			ofxTest(edgeIt.getCurrent().getIncidentFace() == dcel.getInnerFace(), "Inner half edges are bound properly.");
 			ofxTest(edgeIt.getCurrent().getTwin().getIncidentFace().getIndex() == ofDoublyConnectedEdgeList::getOuterFaceIndex(), "Outer half edges are bound properly.");
+			ofxTest(edgeIt.getCurrent().getTwin().getOrigin() == edgeIt.getCurrent().getNext().getOrigin(), "Twin half edges are connected properly.");
 			++count;
 		} while (edgeIt.moveNext());
 
@@ -137,6 +319,47 @@ public:
 		ofxTest(count == 1, "Vertex is on one non-outer face.");
 	}
 
+	void TestDcelInitializeFromBuffers() {
+		title("Testing Dcel Initialization From Buffers");
+
+		vector<glm::vec3> vertices = {
+			{ 0, 0, 5 },
+			{ 1, 0, 5 },
+			{ 1, 1, 5 },
+			{ 0, 1, 5 }
+		};
+
+		vector<float> xs = { 0, 1, 1, 0 };
+		vector<float> ys = { 0, 0, 1, 1 };
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		dcel.initializeFromCCWVertices(&vertices[0].x, vertices.size(), sizeof(glm::vec3));
+
+		auto windingOrder = ofDoublyConnectedEdgeList::getWindingOrder(dcel.getInnerFace());
+		ofxTest(windingOrder == ofPolygonWindingOrder::CounterClockWise, "Correct dcel winding order from strided buffer.");
+		ofxTest(dcel.getNumVertices() == vertices.size(), "Vertices count from strided buffer.");
+
+		auto origin = dcel.getInnerFace().getOuterComponent().getNext().getOrigin();
+		ofxTest(origin.getPosition() == position_t(vertices[1].x, vertices[1].y), "Positions read from strided buffer.");
+
+		dcel.initializeFromCCWVertices(xs.data(), ys.data(), xs.size());
+		origin = dcel.getInnerFace().getOuterComponent().getNext().getNext().getOrigin();
+		ofxTest(origin.getPosition() == position_t(xs[2], ys[2]), "Positions read from separate coordinates.");
+
+		std::reverse(xs.begin(), xs.end());
+		std::reverse(ys.begin(), ys.end());
+
+		bool trew = false;
+		try {
+			dcel.initializeFromCCWVertices(xs.data(), ys.data(), xs.size());
+		} catch (const std::runtime_error &) {
+			trew = true;
+		}
+
+		ofxTest(trew, "Initialize dcel with clockwise coordinates throws.");
+		ofxTest(dcel.getNumVertices() == 0, "Dcel is left empty after a failed initialization.");
+	}
+
 	void TestDcelSplitFaceAdjacentFails() {
 		title("Testing Dcel Split Face Adjacent Fails");
 
@@ -157,7 +380,7 @@ public:
 		bool trew = false;
 		try {
 			dcel.addHalfEdge(vertexA, vertexB);
-		} catch (std::runtime_error error) {
+		} catch (const std::runtime_error &) {
 			trew = true;
 		}
 
@@ -197,6 +420,46 @@ public:
 		} while (faceIt.moveNext());
 	}
 
+	void TestDcelDeferredFaceAssignment() {
+		title("Testing Dcel Deferred Face Assignment");
+
+		vector<glm::vec2> vertices;
+		const auto numVertices = 8;
+		for (auto i = 0; i != numVertices; ++i) {
+			auto angle = 2.0f * glm::pi<float>() * i / numVertices;
+			vertices.push_back({ glm::cos(angle), glm::sin(angle) });
+		}
+		ofPolygonUtility::scaleToScalarRange(vertices);
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		dcel.setFaceAssignment(ofDoublyConnectedEdgeList::FaceAssignment::Deferred);
+		dcel.initializeFromCCWVertices(vertices);
+
+		// Fan triangulation using half edges only, faces are not assigned until we iterate.
+		auto edge = dcel.getInnerFace().getOuterComponent();
+		auto target = edge.getNext().getNext();
+		for (auto i = 2; i != numVertices - 1; ++i) {
+			edge = dcel.addHalfEdge(edge, target);
+			target = target.getNext();
+		}
+
+		auto numFaces = 0;
+		auto faceIt = ofDoublyConnectedEdgeList::FacesIterator(dcel);
+		do {
+			auto count = 0;
+			auto face = faceIt.getCurrent();
+			auto edgeIt = ofDoublyConnectedEdgeList::HalfEdgesIterator(face);
+			do {
+				ofxTest(edgeIt.getCurrent().getIncidentFace() == face, "Deferred face is bound properly.");
+				++count;
+			} while (edgeIt.moveNext());
+			ofxTest(count == 3, "Deferred face vertices count.");
+			++numFaces;
+		} while (faceIt.moveNext());
+
+		ofxTest(numFaces == numVertices - 2, "Deferred faces count.");
+	}
+
 	void TestFacesOnVertexIterator() {
 		title("Testing Test Faces On Vertex Iterator");
 
@@ -228,6 +491,49 @@ public:
 		ofxTest(count == 2, "Faces on vertex iterator traverses proper faces.");
 	}
 
+	void TestPolygonKernels() {
+		title("Polygon Kernels");
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		vector<glm::vec3> vertices;
+		vector<ofSplitToMonotone::VertexType> types;
+		auto matchesClassification = true;
+		auto matchesConvexity = true;
+		auto matchesArea = true;
+
+		// Sizes cover all numbers of vertices left over by vectors.
+		for (auto createPolygon : { createPolygonRandom, createPolygonSpiral }) {
+			for (auto i = 16; i != 96; ++i) {
+				vertices.resize(i);
+				createPolygon(vertices);
+				dcel.initializeFromCCWVertices(vertices);
+
+				for (auto robustPredicates : { false, true }) {
+					types.resize(i);
+					auto isConvex = ofPolygonClassifyVertices(dcel.getPositions(), i, types.data(), robustPredicates);
+					auto isTurnConvex = true;
+
+					for (auto j = 0; j != i; ++j) {
+						auto vertex = ofDoublyConnectedEdgeList::Vertex(&dcel, j);
+						matchesClassification &= types[j] == ofSplitToMonotone::classifyVertex(vertex, robustPredicates);
+						isTurnConvex &= ofOrient2d(vertex.getIncidentEdge().getPrev().getOrigin().getPosition(), vertex.getPosition(), vertex.getIncidentEdge().getDestination().getPosition()) > 0;
+					}
+					matchesConvexity &= isConvex == isTurnConvex;
+				}
+
+				auto area = 0.0;
+				for (auto j = 1; j + 1 < i; ++j) {
+					area += ofOrient2d(dcel.getPositions()[0], dcel.getPositions()[j], dcel.getPositions()[j + 1]);
+				}
+				matchesArea &= std::abs(ofPolygonSignedArea(dcel.getPositions(), i) - area) <= 1e-4 * std::abs(area);
+			}
+		}
+
+		ofxTest(matchesClassification, "Vertices classification matches classify vertex, using " + std::string(ofPolygonKernelsInstructionSet()) + ".");
+		ofxTest(matchesConvexity, "Polygon convexity matches turns.");
+		ofxTest(matchesArea, "Polygon signed area matches.");
+	}
+
 	void TestSplitToMonotone() {
 		title("Split To Monotone");
 
@@ -237,7 +543,7 @@ public:
 
 		for (auto i = 12; i != 64; ++i) {
 			vertices.resize(i);
-			ofPolygonUtility::createPolygonRandom(vertices);
+			createPolygonRandom(vertices);
 			dcel.initializeFromCCWVertices(vertices);
 			splitToMonotone.execute(dcel, dcel.getInnerFace());
 
@@ -261,6 +567,223 @@ public:
 			} while (facesIt.moveNext());
 		}
 		ofxTest(true, "Split to monotone succeeded.");
+
+		// Vertices classified upfront, as the triangulation does to pick its path, give the same split.
+		vector<ofSplitToMonotone::VertexType> verticesClassification(vertices.size());
+		dcel.initializeFromCCWVertices(vertices);
+		splitToMonotone.execute(dcel, dcel.getInnerFace());
+		const auto numFaces = dcel.getNumTriangles();
+
+		dcel.initializeFromCCWVertices(vertices);
+		ofPolygonClassifyVertices(dcel.getPositions(), dcel.getNumVertices(), verticesClassification.data(), false);
+		splitToMonotone.execute(dcel, dcel.getInnerFace(), verticesClassification.data());
+		ofxTest(dcel.getNumTriangles() == numFaces, "Split to monotone with classified vertices succeeded.");
+
+		bool trew = false;
+		try {
+			splitToMonotone.execute(dcel, dcel.getInnerFace(), verticesClassification.data());
+		} catch (const std::runtime_error &) {
+			trew = true;
+		}
+		ofxTest(trew, "Split with classified vertices of a split polygon throws.");
+	}
+
+	void TestSplitToMonotoneReuse() {
+		title("Split To Monotone Reuse");
+
+		// One instance splits polygons of alternating families and sizes, its sweep line status recycling nodes
+		// and indexing them by half edges whose indices, from one polygon to the next, grow, shrink and overlap.
+		// Each triangulation must match the one of a fresh instance.
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto splitToMonotone = ofSplitToMonotone();
+		auto triangulateMonotone = ofTriangulateMonotone();
+		vector<ofDoublyConnectedEdgeList::Face> faces;
+		vector<glm::vec3> vertices;
+		vector<unsigned int> indices;
+		vector<unsigned int> expectedIndices;
+
+		auto triangulate = [&](ofSplitToMonotone & split, vector<unsigned int> & triangles) {
+			dcel.initializeFromCCWVertices(vertices);
+			split.execute(dcel, dcel.getInnerFace());
+
+			faces.clear();
+			auto facesIt = ofDoublyConnectedEdgeList::FacesIterator(dcel);
+			do {
+				faces.push_back(facesIt.getCurrent());
+			} while (facesIt.moveNext());
+
+			for (const auto & face : faces) {
+				triangulateMonotone.execute(dcel, face);
+			}
+
+			triangles.resize(dcel.getNumTriangles() * 3);
+			dcel.extractTriangles(triangles.data());
+		};
+
+		auto succeeded = true;
+		const vector<std::size_t> sizes = { 512, 12, 1024, 64, 2048, 33, 700, 256 };
+		for (std::size_t i = 0; i != sizes.size() * 2; ++i) {
+			vertices.resize(sizes[i % sizes.size()]);
+			switch (i % 3) {
+			case 0:
+				createPolygonRandom(vertices);
+				break;
+			case 1:
+				createPolygonSpiral(vertices);
+				break;
+			default:
+				createPolygonComb(vertices);
+			}
+
+			auto freshSplitToMonotone = ofSplitToMonotone();
+			triangulate(freshSplitToMonotone, expectedIndices);
+			triangulate(splitToMonotone, indices);
+
+			if (indices != expectedIndices || indices.size() != (vertices.size() - 2) * 3) {
+				succeeded = false;
+				break;
+			}
+
+			// A failed split leaves edges in the status, which must not leak into the next one.
+			if (i == sizes.size()) {
+				vertices = { { 46, 42, 0 }, { 43, 56, 0 }, { 94, 14, 0 }, { 78, 20, 0 }, { 72, 80, 0 }, { 80, 97, 0 }, { 9, 31, 0 }, { 52, 69, 0 } };
+				auto trew = false;
+				try {
+					triangulate(splitToMonotone, indices);
+				} catch (const std::runtime_error &) {
+					trew = true;
+				}
+				ofxTest(trew, "Split of a self intersecting polygon throws.");
+			}
+		}
+		ofxTest(succeeded, "Reused split to monotone matches a fresh instance.");
+	}
+
+	void TestSweepLineStatus() {
+		title("Sweep Line Status");
+
+		// Vertical edges, one per column, each inserted when the sweep line meets its top and removed at its bottom.
+		// Tops are met in column order, the sorted insertions degrading a plain binary search tree to a list.
+		// Vertices above all others close the polygon counter clockwise, they are not swept.
+		// Between the corners, they lie right of each column and probe the status away from the sweep line.
+		// The status is checked against a map of the edges crossing the sweep line, keyed by column.
+		const auto numEdges = std::size_t { 256 };
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto status = ofSplitToMonotone::SweepLineStatus();
+		vector<glm::vec3> vertices(numEdges * 3 + 2);
+		vector<index_t> events(numEdges * 2);
+		std::map<index_t, ofDoublyConnectedEdgeList::HalfEdge> reference;
+		auto seed = std::uint32_t { 1 };
+
+		// The helper found left of a vertex, null if there is no edge left of it.
+		auto findLeftHelper = [&status](const ofDoublyConnectedEdgeList::Vertex & vertex) -> ofDoublyConnectedEdgeList::HalfEdge * {
+			try {
+				return &status.findLeftHelper(vertex);
+			} catch (const std::runtime_error &) {
+				return nullptr;
+			}
+		};
+
+		// Whether the helper found left of a vertex is the one of the rightmost column strictly left of a given column.
+		auto isLeftHelper = [&reference](const ofDoublyConnectedEdgeList::HalfEdge * helper, index_t column) {
+			auto left = reference.lower_bound(column);
+			if (left == reference.begin()) {
+				return helper == nullptr;
+			}
+			return helper != nullptr && *helper == std::prev(left)->second;
+		};
+
+		for (auto robustPredicates : { false, true }) {
+			status.clear();
+			status.setRobustPredicates(robustPredicates);
+			auto succeeded = true;
+
+			// Every edge is removed by the end of a pass, the next one recycles its nodes.
+			for (auto pass = 0; pass != 4 && succeeded; ++pass) {
+				const auto leftToRight = pass % 2 == 0;
+				const auto randomLengths = pass >= 2;
+
+				// Columns lie at even abscissas, probes at odd ones, which fixed point coordinates represent exactly.
+				// Tops lie at even heights and bottoms at odd ones, so that edges never start where others end.
+				for (std::size_t i = 0; i != numEdges; ++i) {
+					const auto rank = leftToRight ? i : numEdges - 1 - i;
+					auto length = numEdges / 8;
+					if (randomLengths) {
+						seed = seed * 1664525u + 1013904223u;
+						length = 1 + (seed >> 16) % (numEdges / 4);
+					}
+					const auto top = 4.0f * (numEdges - rank);
+					vertices[i * 2] = glm::vec3(2 * i, top, 0);
+					vertices[i * 2 + 1] = glm::vec3(2 * i, top - (2 * length + 1), 0);
+					vertices[numEdges * 3 - i] = glm::vec3(2 * i + 1, 8 * numEdges, 0);
+				}
+				vertices[numEdges * 2] = glm::vec3(2 * numEdges, 8 * numEdges, 0);
+				vertices[numEdges * 3 + 1] = glm::vec3(-1, 8 * numEdges, 0);
+				dcel.initializeFromCCWVertices(vertices);
+
+				for (std::size_t i = 0; i != events.size(); ++i) {
+					events[i] = i;
+				}
+				std::sort(events.begin(), events.end(), [&vertices](index_t lhs, index_t rhs) {
+					return vertices[lhs].y > vertices[rhs].y;
+				});
+
+				// Any unexpected exception, the status having lost an edge, fails the test.
+				try {
+					for (auto event : events) {
+						const auto vertex = ofDoublyConnectedEdgeList::Vertex(&dcel, event);
+						const auto column = event / 2;
+						// The half edge leaving the top of the column goes down to its bottom.
+						const auto edge = ofDoublyConnectedEdgeList::Vertex(&dcel, column * 2).getIncidentEdge();
+						status.setCoordinate(vertex.getY());
+
+						// The helper of the edge left of the vertex, updated in place as the sweep does.
+						auto helper = findLeftHelper(vertex);
+						if (!isLeftHelper(helper, column)) {
+							succeeded = false;
+							break;
+						}
+						if (helper != nullptr) {
+							*helper = vertex.getIncidentEdge();
+							std::prev(reference.lower_bound(column))->second = *helper;
+						}
+
+						if (event % 2 == 0) {
+							status.emplace(edge, edge);
+							reference[column] = edge;
+						} else {
+							if (status.getHelper(edge) != reference[column]) {
+								succeeded = false;
+								break;
+							}
+							status.remove(edge);
+							reference.erase(column);
+						}
+
+						// Edges left of the probe right of a random column, whose own edge may cross the sweep line.
+						seed = seed * 1664525u + 1013904223u;
+						const auto probe = static_cast<index_t>((seed >> 16) % numEdges);
+						if (!isLeftHelper(findLeftHelper(ofDoublyConnectedEdgeList::Vertex(&dcel, numEdges * 3 - probe)), probe + 1)) {
+							succeeded = false;
+							break;
+						}
+					}
+				} catch (const std::runtime_error &) {
+					succeeded = false;
+				}
+				reference.clear();
+			}
+
+			// Removed edges are unmapped.
+			auto trew = false;
+			try {
+				status.getHelper(ofDoublyConnectedEdgeList::Vertex(&dcel, 0).getIncidentEdge());
+			} catch (const std::runtime_error &) {
+				trew = true;
+			}
+
+			ofxTest(succeeded && trew, string(robustPredicates ? "Sweep line status with robust predicates" : "Sweep line status") + " matches the reference.");
+		}
 	}
 
 	void TestTriangulateMonotone() {
@@ -272,7 +795,7 @@ public:
 
 		for (auto i = 12; i != 64; ++i) {
 			vertices.resize(i);
-			ofPolygonUtility::createPolygonRandomMonotone(vertices);
+			createPolygonRandomMonotone(vertices);
 			dcel.initializeFromCCWVertices(vertices);
 			triangulateMonotone.execute(dcel, dcel.getInnerFace());
 
@@ -305,7 +828,7 @@ public:
 
 		for (auto i = 12; i != 64; ++i) {
 			vertices.resize(i);
-			ofPolygonUtility::createPolygonRandom(vertices);
+			createPolygonRandom(vertices);
 			dcel.initializeFromCCWVertices(vertices);
 			polygonTriangulation.execute(dcel);
 
@@ -327,75 +850,767 @@ public:
 			} while (facesIt.moveNext());
 		}
 		ofxTest(true, "Triangulate succeeded.");
+
+		// A self intersecting polygon, on which the sweep line status gets inconsistent.
+		const vector<glm::vec2> selfIntersecting = { { 46, 42 }, { 43, 56 }, { 94, 14 }, { 78, 20 }, { 72, 80 }, { 80, 97 }, { 9, 31 }, { 52, 69 } };
+		auto restoresFaceAssignment = true;
+		for (auto faceAssignment : { ofDoublyConnectedEdgeList::FaceAssignment::Immediate, ofDoublyConnectedEdgeList::FaceAssignment::Deferred }) {
+			dcel.initializeFromCCWVertices(selfIntersecting);
+			dcel.setFaceAssignment(faceAssignment);
+
+			bool trew = false;
+			try {
+				polygonTriangulation.execute(dcel);
+			} catch (const std::runtime_error &) {
+				trew = true;
+			}
+			restoresFaceAssignment &= trew && dcel.getFaceAssignment() == faceAssignment;
+		}
+		ofxTest(restoresFaceAssignment, "Failed triangulation restores the face assignment mode.");
 	}
 
-	void SpeedTestTriangulateMonotone() {
-		title("Triangulate Monotone (Speed)");
+	void TestExtractTriangles() {
+		title("Extract Triangles");
+
+		vector<glm::vec3> vertices = {
+			{ 0, 0, 0 },
+			{ 1, 0, 0 },
+			{ 2, 1, 0 },
+			{ 1, 2, 0 },
+			{ 0, 1, 0 }
+		};
 
 		auto dcel = ofDoublyConnectedEdgeList();
-		auto triangulateMonotone = ofTriangulateMonotone();
+		auto polygonTriangulation = ofPolygonTriangulation();
+		dcel.initializeFromCCWVertices(vertices);
+		polygonTriangulation.execute(dcel);
+
+		const auto numTriangles = dcel.getNumTriangles();
+		ofxTest(numTriangles == vertices.size() - 2, "Triangles count.");
+
+		vector<glm::vec3> extractedVertices;
+		vector<unsigned int> indices;
+		dcel.extractTriangles(extractedVertices, indices);
+		ofxTest(extractedVertices == vertices, "Extracted vertices match polygon.");
+
+		const std::uint16_t baseVertex = 10;
+		vector<std::uint16_t> shortIndices(numTriangles * 3);
+		dcel.extractTriangles(shortIndices.data(), baseVertex);
+
+		auto offsetIndicesMatch = true;
+		for (std::size_t i = 0; i != indices.size(); ++i) {
+			offsetIndicesMatch &= shortIndices[i] == indices[i] + baseVertex;
+		}
+		ofxTest(offsetIndicesMatch, "16 bits indices are offset by base vertex.");
+
+		bool trew = false;
+		try {
+			dcel.extractTriangles(shortIndices.data(), std::numeric_limits<std::uint16_t>::max());
+		} catch (const std::runtime_error &) {
+			trew = true;
+		}
+		ofxTest(trew, "Indices overflowing the index type throw.");
+
+		// Interleaved position and color.
+		vector<float> interleaved(vertices.size() * 7, -1.0f);
+		dcel.extractVertices(interleaved.data(), sizeof(float) * 7);
+		ofxTest(interleaved[7 * 2] == 2 && interleaved[7 * 2 + 1] == 1 && interleaved[7 * 2 + 2] == 0, "Strided vertices are written.");
+		ofxTest(interleaved[7 * 2 + 3] == -1.0f, "Other attributes are left untouched.");
+	}
+
+	void TestOptimizeVertexCache() {
+		title("Optimize Vertex Cache");
+
+		vector<unsigned int> singleTriangle = { 0, 1, 2 };
+		vector<unsigned int> fan = { 0, 1, 2, 0, 2, 3, 0, 3, 4 };
+		ofxTest(ofOptimizeVertexCache::getAverageCacheMissRatio(singleTriangle) == 3.0f
+				&& ofOptimizeVertexCache::getAverageCacheMissRatio(fan) == 5.0f / 3.0f
+				&& ofOptimizeVertexCache::getAverageCacheMissRatio(fan, 2) == 2.0f,
+			"Average cache miss ratio of a first in first out cache.");
+
+		// Triangles as sorted triples of indices, rotated to start at their smallest index so that winding is kept.
+		auto getTriangles = [](const vector<unsigned int> & indices) {
+			vector<std::array<unsigned int, 3>> triangles;
+			for (std::size_t i = 0; i < indices.size(); i += 3) {
+				std::array<unsigned int, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+				std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+				triangles.push_back(triangle);
+			}
+			std::sort(triangles.begin(), triangles.end());
+			return triangles;
+		};
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto polygonTriangulation = ofPolygonTriangulation();
+		auto optimizeVertexCache = ofOptimizeVertexCache();
+		vector<glm::vec3> vertices(4096);
+		vector<glm::vec3> extractedVertices;
+		vector<unsigned int> indices;
+		vector<unsigned int> optimizedIndices;
+
+		auto reducesMisses = true;
+		auto keepsTriangles = true;
+		for (auto createPolygon : { createPolygonRandom, createPolygonSpiral, createPolygonComb }) {
+			createPolygon(vertices);
+			dcel.initializeFromCCWVertices(vertices);
+			polygonTriangulation.execute(dcel);
+			dcel.extractTriangles(extractedVertices, indices);
+
+			optimizeVertexCache.execute(dcel);
+			dcel.extractTriangles(extractedVertices, optimizedIndices);
+
+			reducesMisses &= ofOptimizeVertexCache::getAverageCacheMissRatio(optimizedIndices)
+				< ofOptimizeVertexCache::getAverageCacheMissRatio(indices);
+			keepsTriangles &= getTriangles(optimizedIndices) == getTriangles(indices);
+		}
+		ofxTest(reducesMisses, "Reordered triangles reduce cache misses.");
+		ofxTest(keepsTriangles, "Reordered triangles match triangulation.");
+
+		// Reordering is an option of triangulations from vertices.
+		polygonTriangulation.setOptimizeVertexCache(true);
+		polygonTriangulation.execute(vertices, indices);
+		ofxTest(indices == optimizedIndices, "Triangulation reorders triangles.");
+	}
+
+	void TestTriangulationPaths() {
+		title("Triangulation Paths");
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto polygonTriangulation = ofPolygonTriangulation();
 		vector<glm::vec3> vertices;
-		double duration = 0.0;
 
-		for (auto k = 0; k != 1024; ++k) {
-			for (auto i = 12; i != 64; ++i) {
+		auto countFaces = [&dcel]() {
+			auto numFaces = 0;
+			auto facesIt = ofDoublyConnectedEdgeList::FacesIterator(dcel);
+			do {
+				if (ofDoublyConnectedEdgeList::getWindingOrder(facesIt.getCurrent()) != ofPolygonWindingOrder::CounterClockWise) {
+					return -1;
+				}
+				++numFaces;
+			} while (facesIt.moveNext());
+			return numFaces;
+		};
+
+		// Regular polygon.
+		const auto numVertices = 64;
+		for (auto i = 0; i != numVertices; ++i) {
+			auto angle = glm::pi<float>() * 2.0f * i / numVertices;
+			vertices.push_back({ glm::cos(angle), glm::sin(angle), 0 });
+		}
+		ofPolygonUtility::scaleToScalarRange(vertices);
+
+		dcel.initializeFromCCWVertices(vertices);
+		polygonTriangulation.execute(dcel);
+		ofxTest(polygonTriangulation.getPath() == ofPolygonTriangulation::Path::Convex, "Convex polygon is triangulated as a fan.");
+		ofxTest(countFaces() == numVertices - 2, "Convex polygon triangulation.");
+
+		vertices.resize(numVertices);
+		createPolygonRandomMonotone(vertices);
+		dcel.initializeFromCCWVertices(vertices);
+		polygonTriangulation.execute(dcel);
+		ofxTest(polygonTriangulation.getPath() == ofPolygonTriangulation::Path::Monotone, "Monotone polygon is not split.");
+		ofxTest(countFaces() == numVertices - 2, "Monotone polygon triangulation.");
+
+		createPolygonSpiral(vertices);
+		dcel.initializeFromCCWVertices(vertices);
+		polygonTriangulation.execute(dcel);
+		ofxTest(polygonTriangulation.getPath() == ofPolygonTriangulation::Path::SplitToMonotone, "Spiral polygon is split to monotone.");
+		ofxTest(countFaces() == numVertices - 2, "Spiral polygon triangulation.");
+	}
+
+	void TestTriangulatePolygonFamilies() {
+		title("Triangulate Polygon Families");
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto polygonTriangulation = ofPolygonTriangulation();
+		vector<glm::vec3> vertices;
+
+		for (auto createPolygon : { createPolygonSpiral, createPolygonComb }) {
+			for (auto i = 16; i < 512; i += 7) {
 				vertices.resize(i);
-				ofPolygonUtility::createPolygonRandomMonotone(vertices);
+				createPolygon(vertices);
+				if (ofDoublyConnectedEdgeList::getWindingOrder(vertices) != ofPolygonWindingOrder::CounterClockWise) {
+					ofxTest(false, "Generated polygon is counter clockwise.");
+					return;
+				}
 				dcel.initializeFromCCWVertices(vertices);
-				auto start = std::chrono::high_resolution_clock::now();
-				triangulateMonotone.execute(dcel, dcel.getInnerFace());
-				auto end = std::chrono::high_resolution_clock::now();
-				duration += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+				polygonTriangulation.execute(dcel);
+
+				auto numFaces = 0;
+				auto facesIt = ofDoublyConnectedEdgeList::FacesIterator(dcel);
+				do {
+					++numFaces;
+				} while (facesIt.moveNext());
+
+				if (numFaces != i - 2) {
+					ofxTest(false, "Triangulate polygon family failed.");
+					return;
+				}
 			}
 		}
+		ofxTest(true, "Triangulate polygon families succeeded.");
+	}
+
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+	void TestMemoryResource() {
+		title("Memory Resource");
+
+		vector<vector<glm::vec3>> polygons;
+		for (auto i : { 8, 64, 1024 }) {
+			polygons.emplace_back(i);
+			createPolygonRandom(polygons.back());
+		}
+
+		// Created first, as they take the default resource as upstream.
+		auto arena = std::pmr::monotonic_buffer_resource();
+		auto pool = std::pmr::synchronized_pool_resource(&arena);
+
+		// Any allocation from the default resource then throws.
+		auto defaultResource = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+		auto allocatesFromResource = true;
+		auto batchAllocatesFromResource = true;
 
-		duration *= 1e-9; // To seconds.
+		try {
+			auto dcel = ofDoublyConnectedEdgeList(&arena);
+			auto polygonTriangulation = ofPolygonTriangulation(&arena);
+			polygonTriangulation.setNumThreads(2);
+			polygonTriangulation.setConcurrentThreshold(0);
+			vector<unsigned int> indices;
+
+			for (const auto & polygon : polygons) {
+				dcel.initializeFromCCWVertices(polygon);
+				polygonTriangulation.execute(dcel);
+				// Small polygons are ear clipped, others go through the internal edge list.
+				polygonTriangulation.execute(polygon, indices);
+			}
+		} catch (const std::bad_alloc &) {
+			allocatesFromResource = false;
+		}
 
-		ofLogNotice() << "duration: " << duration << "sec.";
+		try {
+			auto batchTriangulation = ofPolygonBatchTriangulation(4, &pool);
+			vector<glm::vec3> vertices;
+			vector<unsigned int> indices;
+			batchTriangulation.execute(polygons, vertices, indices);
+		} catch (const std::bad_alloc &) {
+			batchAllocatesFromResource = false;
+		}
+
+		std::pmr::set_default_resource(defaultResource);
+		ofxTest(allocatesFromResource, "Triangulation allocates from the memory resource.");
+		ofxTest(batchAllocatesFromResource, "Batch triangulation allocates from the memory resource.");
+	}
+#endif
+
+#ifdef OF_POLYGON_TRIANGULATION_STATS
+	void TestStats() {
+		title("Stats");
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto polygonTriangulation = ofPolygonTriangulation();
+		auto stats = ofPolygonTriangulationStats();
+		polygonTriangulation.setStats(&stats);
+
+		const auto numVertices = 1024;
+		vector<glm::vec3> vertices(numVertices);
+		vector<unsigned int> indices;
+
+		// Convex polygons are a single monotone polygon.
+		for (auto i = 0; i != numVertices; ++i) {
+			auto angle = glm::pi<float>() * 2.0f * i / numVertices;
+			vertices[i] = { glm::cos(angle), glm::sin(angle), 0 };
+		}
+		ofPolygonUtility::scaleToScalarRange(vertices);
+
+		dcel.initializeFromCCWVertices(vertices);
+		polygonTriangulation.execute(dcel);
+		ofxTest(stats.numDiagonals == numVertices - 3 && stats.numMonotonePolygons == 1
+				&& stats.numSplitVertices == 0 && stats.numMergeVertices == 0,
+			"Convex polygon stats.");
+		ofxTest(dcel.getStats() == nullptr, "Stats are detached from the edge list after triangulation.");
+
+		// Polygons passed as vertices go through the internal edge list, winding check and extraction included.
+		stats.reset();
+		createPolygonRandom(vertices);
+		polygonTriangulation.execute(vertices, indices);
+		ofxTest(polygonTriangulation.getPath() == ofPolygonTriangulation::Path::SplitToMonotone, "Random polygon is split to monotone.");
+		ofxTest(stats.numDiagonals == numVertices - 3, "Diagonals count.");
+		ofxTest(stats.numSplitVertices + stats.numMergeVertices > 0 && stats.numMonotonePolygons > 1, "Split and merge vertices count.");
+		ofxTest(stats.numFaceRelabels >= 3 * (numVertices - 2), "Face relabels count.");
+		ofxTest(stats.windingCheck.count() > 0 && stats.classification.count() > 0 && stats.sort.count() > 0
+				&& stats.sweep.count() > 0 && stats.monotoneTriangulation.count() > 0 && stats.extraction.count() > 0,
+			"Phases are timed.");
+
+		// Shared faces are looked up when adding half edges between vertices.
+		stats.reset();
+		dcel.initializeFromCCWVertices(vertices);
+		dcel.setStats(&stats);
+		dcel.addHalfEdge(ofDoublyConnectedEdgeList::Vertex(&dcel, 0), ofDoublyConnectedEdgeList::Vertex(&dcel, 2));
+		ofxTest(stats.numSharedFaceIterations > 0 && stats.numDiagonals == 1, "Edge list stats.");
+
+		polygonTriangulation.setStats(nullptr);
+		dcel.setStats(nullptr);
+		stats.reset();
+		dcel.initializeFromCCWVertices(vertices);
+		polygonTriangulation.execute(dcel);
+		ofxTest(stats.numDiagonals == 0 && stats.sweep.count() == 0, "Detached stats are left untouched.");
+	}
+#endif
+
+	void TestSteadyStateAllocations() {
+		title("Steady State Allocations");
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto splitToMonotone = ofSplitToMonotone();
+		auto triangulateMonotone = ofTriangulateMonotone();
+		auto polygonTriangulation = ofPolygonTriangulation();
+		auto optimizeVertexCache = ofOptimizeVertexCache();
+		auto optimizedTriangulation = ofPolygonTriangulation();
+		optimizedTriangulation.setOptimizeVertexCache(true);
+		// Threads wait between triangulations, every polygon is triangulated concurrently.
+		auto concurrentTriangulation = ofPolygonTriangulation();
+		concurrentTriangulation.setNumThreads(4);
+		concurrentTriangulation.setConcurrentThreshold(0);
+		vector<glm::vec3> extractedVertices;
+		vector<unsigned int> indices;
+
+		// Polygons of each family, the largest ones first, small ones are ear clipped.
+		vector<vector<glm::vec3>> polygons;
+		vector<vector<glm::vec3>> monotonePolygons;
+		for (auto size : { 1024, 500, 64, 12 }) {
+			for (auto createPolygon : { createPolygonRandom, createPolygonSpiral, createPolygonComb }) {
+				// Spirals degenerate below a few dozens vertices.
+				if (size < 16 && createPolygon != createPolygonRandom) {
+					continue;
+				}
+				polygons.emplace_back(size);
+				createPolygon(polygons.back());
+			}
+			monotonePolygons.emplace_back(size);
+			createPolygonRandomMonotone(monotonePolygons.back());
+		}
+
+		// Allocations counted per call.
+		struct CallSite {
+			string name;
+			std::size_t numAllocations;
+		};
+
+		vector<CallSite> callSites = {
+			{ "ofDoublyConnectedEdgeList::initializeFromCCWVertices", 0 },
+			{ "ofSplitToMonotone::execute", 0 },
+			{ "ofTriangulateMonotone::execute", 0 },
+			{ "ofPolygonTriangulation::execute, edge list", 0 },
+			{ "ofDoublyConnectedEdgeList::extractTriangles", 0 },
+			{ "ofPolygonTriangulation::execute, vertices", 0 },
+			{ "ofOptimizeVertexCache::execute", 0 },
+			{ "ofPolygonTriangulation::execute, vertices, vertex cache optimization", 0 },
+			{ "ofPolygonTriangulation::execute, edge list, 4 threads", 0 }
+		};
+
+		auto count = [&callSites](std::size_t callSite, const auto & call) {
+			const auto numAllocations = s_NumAllocations.load();
+			call();
+			callSites[callSite].numAllocations += s_NumAllocations.load() - numAllocations;
+		};
+
+		auto run = [&]() {
+			for (const auto & polygon : polygons) {
+				count(0, [&]() { dcel.initializeFromCCWVertices(polygon); });
+				count(1, [&]() { splitToMonotone.execute(dcel, dcel.getInnerFace()); });
+
+				count(0, [&]() { dcel.initializeFromCCWVertices(polygon); });
+				count(3, [&]() { polygonTriangulation.execute(dcel); });
+				count(4, [&]() { dcel.extractTriangles(extractedVertices, indices); });
+				count(6, [&]() { optimizeVertexCache.execute(dcel); });
+
+				count(0, [&]() { dcel.initializeFromCCWVertices(polygon); });
+				count(8, [&]() { concurrentTriangulation.execute(dcel); });
+
+				count(5, [&]() { polygonTriangulation.execute(polygon, indices); });
+				count(7, [&]() { optimizedTriangulation.execute(polygon, indices); });
+			}
+
+			for (const auto & polygon : monotonePolygons) {
+				count(0, [&]() { dcel.initializeFromCCWVertices(polygon); });
+				count(2, [&]() { triangulateMonotone.execute(dcel, dcel.getInnerFace()); });
+			}
+		};
+
+		// Warm up, instances keep their memory for polygons with as many vertices or less.
+		run();
+		for (auto & callSite : callSites) {
+			callSite.numAllocations = 0;
+		}
+
+		run();
+		for (const auto & callSite : callSites) {
+			ofxTest(callSite.numAllocations == 0,
+				callSite.name + " does not allocate once warmed up, " + std::to_string(callSite.numAllocations) + " allocations.");
+		}
+
+		// Convex polygons are triangulated as a fan, all triangles sharing a vertex, the worst case of reordering.
+		vector<glm::vec3> convexPolygon(1024);
+		for (std::size_t i = 0; i != convexPolygon.size(); ++i) {
+			const auto angle = glm::pi<float>() * 2.0f * i / convexPolygon.size();
+			convexPolygon[i] = glm::vec3(std::cos(angle), std::sin(angle), 0.0f);
+		}
+		ofPolygonUtility::scaleToScalarRange(convexPolygon);
+		dcel.initializeFromCCWVertices(convexPolygon);
+		polygonTriangulation.execute(dcel);
+
+		auto reservedOptimizeVertexCache = ofOptimizeVertexCache();
+		reservedOptimizeVertexCache.reserve(convexPolygon.size());
+		const auto numAllocations = s_NumAllocations.load();
+		reservedOptimizeVertexCache.execute(dcel);
+		ofxTest(s_NumAllocations.load() == numAllocations, "ofOptimizeVertexCache::execute does not allocate once reserved.");
 	}
 
-	void SpeedTestTriangulate() {
-		title("Triangulate (Speed)");
+	void TestConcurrentMonotoneTriangulation() {
+		title("Concurrent Monotone Triangulation");
 
 		auto dcel = ofDoublyConnectedEdgeList();
 		auto polygonTriangulation = ofPolygonTriangulation();
+		auto concurrentPolygonTriangulation = ofPolygonTriangulation();
+		concurrentPolygonTriangulation.setNumThreads(4);
+		concurrentPolygonTriangulation.setConcurrentThreshold(0);
+
 		vector<glm::vec3> vertices;
-		double duration = 0.0;
+		vector<glm::vec3> extractedVertices;
+		vector<unsigned int> indices;
+		vector<unsigned int> concurrentIndices;
 
-		for (auto k = 0; k != 1024; ++k) {
-			for (auto i = 12; i != 64; ++i) {
+		for (auto createPolygon : { createPolygonRandom, createPolygonSpiral, createPolygonComb }) {
+			for (auto i = 16; i < 2048; i *= 2) {
 				vertices.resize(i);
-				ofPolygonUtility::createPolygonRandom(vertices);
+				createPolygon(vertices);
+
 				dcel.initializeFromCCWVertices(vertices);
-				auto start = std::chrono::high_resolution_clock::now();
 				polygonTriangulation.execute(dcel);
-				auto end = std::chrono::high_resolution_clock::now();
-				duration += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+				dcel.extractTriangles(extractedVertices, indices);
+
+				dcel.initializeFromCCWVertices(vertices);
+				concurrentPolygonTriangulation.execute(dcel);
+				dcel.extractTriangles(extractedVertices, concurrentIndices);
+
+				if (indices != concurrentIndices) {
+					ofxTest(false, "Concurrent triangulation matches single threaded triangulation.");
+					return;
+				}
 			}
 		}
+		ofxTest(true, "Concurrent triangulation matches single threaded triangulation.");
+	}
 
-		duration *= 1e-9; // To seconds.
+	void TestSmallPolygonTriangulation() {
+		title("Small Polygon Triangulation");
 
-		ofLogNotice() << "duration: " << duration << "sec.";
+		auto polygonTriangulation = ofPolygonTriangulation();
+		vector<glm::vec3> vertices;
+		vector<unsigned int> indices;
+
+		auto getArea = [](const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c) {
+			return 0.5f * ((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+		};
+
+		for (auto createPolygon : { createPolygonRandom, createPolygonRandomMonotone }) {
+			for (std::size_t i = 3; i < polygonTriangulation.getSmallPolygonThreshold(); ++i) {
+				vertices.resize(i);
+				createPolygon(vertices);
+				polygonTriangulation.execute(vertices, indices);
+
+				if (indices.size() != (i - 2) * 3) {
+					ofxTest(false, "Small polygon triangles count.");
+					return;
+				}
+
+				auto polygonArea = 0.0f;
+				for (std::size_t j = 1; j + 1 < i; ++j) {
+					polygonArea += getArea(vertices[0], vertices[j], vertices[j + 1]);
+				}
+
+				auto trianglesArea = 0.0f;
+				for (std::size_t j = 0; j != indices.size(); j += 3) {
+					auto area = getArea(vertices[indices[j]], vertices[indices[j + 1]], vertices[indices[j + 2]]);
+					if (area <= 0.0f) {
+						ofxTest(false, "Small polygon triangles are counter clockwise.");
+						return;
+					}
+					trianglesArea += area;
+				}
+
+				// Polygons span the unit square, or larger ones with fixed point coordinates.
+				if (!ApproximatelyEqual(polygonArea, trianglesArea, 1e-4f * std::max(polygonArea, 1.0f))) {
+					ofxTest(false, "Small polygon triangles cover the polygon.");
+					return;
+				}
+			}
+		}
+		ofxTest(true, "Small polygon triangulation succeeded.");
+
+		vertices = {
+			{ 0, 0, 0 },
+			{ 0, 1, 0 },
+			{ 1, 1, 0 },
+			{ 1, 0, 0 }
+		};
+
+		bool trew = false;
+		try {
+			polygonTriangulation.execute(vertices, indices);
+		} catch (const std::runtime_error &) {
+			trew = true;
+		}
+		ofxTest(trew, "Small polygon with clockwise vertices throws.");
+	}
+
+	void TestRobustPredicates() {
+		title("Robust Predicates");
+
+		// Nearly collinear points, the exact orientation of the last one is the opposite of its offset sign.
+		auto isExact = true;
+		const auto a = glm::vec2(0.5f, 0.5f);
+		const auto b = glm::vec2(12.0f, 12.0f);
+		for (auto i = -8; i <= 8; ++i) {
+			const auto c = glm::vec2(24.0f + i * std::ldexp(1.0f, -19), 24.0f);
+			const auto orientation = ofOrient2dAdaptive(a, b, c);
+			isExact &= i == 0 ? orientation == 0.0 : (orientation > 0.0) == (i < 0);
+		}
+		ofxTest(isExact, "Adaptive orientation is exact.");
+
+		// A polygon whose edges are misordered along the sweep line when intersections are rounded.
+		const vector<glm::vec2> grid = {
+			{ 163, 5 }, { 203, 52 }, { 135, 154 }, { 108, 139 }, { 144, 186 }, { 30, 39 }, { -100, 117 },
+			{ -73, 75 }, { -110, 42 }, { -165, 47 }, { -87, 2 }, { -235, -15 }, { -121, -34 }, { -204, -104 },
+			{ -184, -101 }, { -128, -71 }, { -198, -133 }, { -30, -78 }, { -48, -149 }, { 29, -120 },
+			{ 73, -143 }, { 94, -111 }, { 152, -128 }, { 40, -25 }, { 236, -12 }
+		};
+
+		// Float spacing is 1/16 around 1e6, so that vertices are exact, fixed point coordinates use the grid as is.
+		const auto offset = glm::vec2(1e6f, 1e6f);
+		const auto spacing = std::is_integral<scalar_t>::value ? 1.0f : 16.0f;
+		vector<glm::vec2> vertices;
+		for (const auto & point : grid) {
+			vertices.push_back(offset + point / spacing);
+		}
+
+		auto polygonTriangulation = ofPolygonTriangulation();
+		polygonTriangulation.setSmallPolygonThreshold(0);
+		polygonTriangulation.setRobustPredicates(true);
+		vector<unsigned int> indices;
+
+		bool trew = false;
+		try {
+			polygonTriangulation.execute(vertices, indices);
+		} catch (const std::runtime_error &) {
+			trew = true;
+		}
+		ofxTest(!trew && indices.size() == (grid.size() - 2) * 3, "Large coordinates polygon triangulated with robust predicates.");
+
+		// Areas are evaluated on the grid, where they are exact.
+		auto getArea = [](const glm::vec2 & a, const glm::vec2 & b, const glm::vec2 & c) {
+			return (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+		};
+
+		auto polygonArea = 0.0f;
+		for (std::size_t i = 1; i + 1 < grid.size(); ++i) {
+			polygonArea += getArea(grid[0], grid[i], grid[i + 1]);
+		}
+
+		auto trianglesArea = 0.0f;
+		auto isCounterClockwise = true;
+		for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+			auto area = getArea(grid[indices[i]], grid[indices[i + 1]], grid[indices[i + 2]]);
+			isCounterClockwise &= area > 0.0f;
+			trianglesArea += area;
+		}
+		ofxTest(isCounterClockwise && polygonArea == trianglesArea, "Large coordinates polygon triangles cover the polygon.");
+	}
+
+	void TestBatchTriangulation() {
+		title("Batch Triangulation");
+
+		vector<vector<glm::vec3>> polygons;
+		for (auto createPolygon : { createPolygonRandom, createPolygonSpiral, createPolygonComb }) {
+			for (auto i = 16; i < 256; i += 7) {
+				polygons.emplace_back(i);
+				createPolygon(polygons.back());
+			}
+		}
+
+		auto batchTriangulation = ofPolygonBatchTriangulation(4);
+		vector<glm::vec3> vertices;
+		vector<unsigned int> indices;
+		batchTriangulation.execute(polygons, vertices, indices);
+
+		auto dcel = ofDoublyConnectedEdgeList();
+		auto polygonTriangulation = ofPolygonTriangulation();
+		vector<glm::vec3> polygonVertices;
+		vector<unsigned int> polygonIndices;
+
+		for (std::size_t i = 0; i != polygons.size(); ++i) {
+			dcel.initializeFromCCWVertices(polygons[i]);
+			polygonTriangulation.execute(dcel);
+			dcel.extractTriangles(polygonVertices, polygonIndices);
+
+			const auto vertexOffset = batchTriangulation.getVertexOffset(i);
+			const auto indexOffset = batchTriangulation.getIndexOffset(i);
+
+			if (batchTriangulation.getIndexOffset(i + 1) - indexOffset != polygonIndices.size()) {
+				ofxTest(false, "Batch triangulation indices count.");
+				return;
+			}
+
+			for (std::size_t j = 0; j != polygonVertices.size(); ++j) {
+				if (vertices[vertexOffset + j] != polygonVertices[j]) {
+					ofxTest(false, "Batch triangulation vertices match.");
+					return;
+				}
+			}
+
+			for (std::size_t j = 0; j != polygonIndices.size(); ++j) {
+				if (indices[indexOffset + j] != polygonIndices[j] + vertexOffset) {
+					ofxTest(false, "Batch triangulation indices match.");
+					return;
+				}
+			}
+		}
+		ofxTest(batchTriangulation.getVertexOffset(polygons.size()) == vertices.size(), "Batch triangulation vertices count.");
+		ofxTest(batchTriangulation.getIndexOffset(polygons.size()) == indices.size(), "Batch triangulation indices count.");
+
+		std::reverse(polygons[polygons.size() / 2].begin(), polygons[polygons.size() / 2].end());
+
+		bool trew = false;
+		try {
+			batchTriangulation.execute(polygons, vertices, indices);
+		} catch (const std::runtime_error &) {
+			trew = true;
+		}
+		ofxTest(trew, "Batch triangulation with a clockwise polygon throws.");
+		std::reverse(polygons[polygons.size() / 2].begin(), polygons[polygons.size() / 2].end());
+
+		// Options are forwarded to each polygon triangulation, threads keep running after an error.
+		batchTriangulation.setSmallPolygonThreshold(64);
+		batchTriangulation.setOptimizeVertexCache(true);
+		polygonTriangulation.setSmallPolygonThreshold(64);
+		polygonTriangulation.setOptimizeVertexCache(true);
+		batchTriangulation.execute(polygons, vertices, indices);
+
+		auto matchesOptions = true;
+		for (std::size_t i = 0; i != polygons.size(); ++i) {
+			polygonTriangulation.execute(polygons[i], polygonIndices);
+			const auto vertexOffset = static_cast<unsigned int>(batchTriangulation.getVertexOffset(i));
+			for (std::size_t j = 0; j != polygonIndices.size(); ++j) {
+				matchesOptions &= indices[batchTriangulation.getIndexOffset(i) + j] == polygonIndices[j] + vertexOffset;
+			}
+		}
+		ofxTest(matchesOptions, "Batch triangulation options match triangulation options.");
+
+		// Threads are started once, a batch only wakes them up.
+		polygons.clear();
+		batchTriangulation.execute(polygons, vertices, indices);
+		const auto numAllocations = s_NumAllocations.load();
+		batchTriangulation.execute(polygons, vertices, indices);
+		ofxTest(s_NumAllocations.load() == numAllocations, "Batch triangulation reuses its threads.");
+	}
+
+	void TestWorkspaceTriangulation() {
+		title("Workspace Triangulation");
+
+		// Small polygons are ear clipped, others go through the edge list of the workspace.
+		vector<vector<glm::vec3>> polygons;
+		for (auto i = 8; i < 600; i += 37) {
+			polygons.emplace_back(i);
+			createPolygonRandom(polygons.back());
+		}
+
+		auto polygonTriangulation = ofPolygonTriangulation();
+		vector<vector<unsigned int>> expectedIndices(polygons.size());
+		for (std::size_t i = 0; i != polygons.size(); ++i) {
+			polygonTriangulation.execute(polygons[i], expectedIndices[i]);
+		}
+
+		// Each thread triangulates all polygons with its own workspace.
+		const auto numThreads = 4;
+		vector<ofPolygonTriangulation::Workspace> workspaces(numThreads);
+		vector<vector<vector<unsigned int>>> indices(numThreads, vector<vector<unsigned int>>(polygons.size()));
+		vector<std::thread> threads;
+		for (auto t = 0; t != numThreads; ++t) {
+			threads.emplace_back([&, t]() {
+				for (std::size_t i = 0; i != polygons.size(); ++i) {
+					indices[t][i].resize((polygons[i].size() - 2) * 3);
+					ofPolygonTriangulation::triangulate(polygons[i], indices[t][i].data(), 0, workspaces[t]);
+				}
+			});
+		}
+		for (auto & thread : threads) {
+			thread.join();
+		}
+
+		auto matches = true;
+		for (const auto & threadIndices : indices) {
+			matches &= threadIndices == expectedIndices;
+		}
+		ofxTest(matches, "Concurrent workspace triangulations match instance triangulation.");
+
+		// Workspaces are moved along with their memory.
+		auto workspace = std::move(workspaces.front());
+		auto dcel = ofDoublyConnectedEdgeList();
+		dcel.initializeFromCCWVertices(polygons.back());
+		auto options = ofPolygonTriangulation::Options();
+		options.robustPredicates = true;
+		const auto path = ofPolygonTriangulation::triangulate(dcel, workspace, options);
+		ofxTest(path == ofPolygonTriangulation::Path::SplitToMonotone && dcel.getNumTriangles() + 2 == polygons.back().size(),
+			"Moved workspace triangulates an edge list.");
+
+		// Buffers of points are read through a view.
+		const auto & polygon = polygons.back();
+		vector<float> positions;
+		for (const auto & vertex : polygon) {
+			positions.insert(positions.end(), { vertex.x, vertex.y, 0, 1 });
+		}
+		vector<unsigned int> viewIndices((polygon.size() - 2) * 3);
+		ofPolygonTriangulation::triangulate(
+			ofPolygonVerticesView(positions.data(), polygon.size(), 4 * sizeof(float)), viewIndices.data(), 0, workspace);
+		ofxTest(viewIndices == expectedIndices.back(), "Strided buffer view triangulation.");
 	}
 
 	void run() {
 		TestWindingOrder();
 		TestMaxInnerAngle();
+		TestPseudoAngle();
+		TestVertexSweepKeys();
+		TestScalarTypes();
+		TestIndexTypes();
 		TestPolygonSimplification();
 		TestDcelConstruction();
+		TestDcelInitializeFromBuffers();
 		TestDcelSplitFaceAdjacentFails();
 		TestDcelSplit();
+		TestDcelDeferredFaceAssignment();
 		TestFacesOnVertexIterator();
 		TestSplitToMonotone();
+		TestSplitToMonotoneReuse();
+		TestSweepLineStatus();
+		TestPolygonKernels();
 		TestTriangulateMonotone();
 		TestTriangulate();
-
-		// Speed tests, no need to run by default.
-#if false
-		SpeedTestTriangulate();
-		SpeedTestTriangulateMonotone();
+		TestTriangulatePolygonFamilies();
+		TestTriangulationPaths();
+		TestExtractTriangles();
+		TestOptimizeVertexCache();
+		TestSmallPolygonTriangulation();
+		TestBatchTriangulation();
+		TestWorkspaceTriangulation();
+		TestConcurrentMonotoneTriangulation();
+		TestSteadyStateAllocations();
+#ifdef OF_POLYGON_TRIANGULATION_PMR
+		TestMemoryResource();
+#endif
+#ifdef OF_POLYGON_TRIANGULATION_STATS
+		TestStats();
 #endif
+		TestRobustPredicates();
 	}
 };
 